@@ -71,6 +71,7 @@ namespace graphene { namespace app {
 
        for( const std::string& api_name : acc->allowed_apis )
           enable_api( api_name );
+       _access_info = acc;
        return true;
     }
 
@@ -96,6 +97,10 @@ namespace graphene { namespace app {
        {
           _crypto_api = std::make_shared< crypto_api >();
        }
+       else if( api_name == "profiling_api" )
+       {
+          _profiling_api = std::make_shared< profiling_api >( std::ref(_app) );
+       }
        else if( api_name == "debug_api" )
        {
           // can only enable this API if the plugin was loaded
@@ -189,6 +194,11 @@ namespace graphene { namespace app {
        return _app.p2p_node()->get_connected_peers();
     }
 
+    std::vector<net::peer_telemetry> network_node_api::get_peer_telemetry() const
+    {
+       return _app.p2p_node()->get_peer_telemetry();
+    }
+
     std::vector<net::potential_peer_record> network_node_api::get_potential_peers() const
     {
        return _app.p2p_node()->get_potential_peers();
@@ -204,6 +214,22 @@ namespace graphene { namespace app {
        return _app.p2p_node()->set_advanced_node_parameters(params);
     }
 
+    profiling_api::profiling_api( application& a ) : _app( a )
+    {
+    }
+
+    execution_profile profiling_api::get_execution_profile() const
+    {
+       return _app.chain_database()->get_execution_profiler().get_profile();
+    }
+
+    void profiling_api::set_execution_profiling(bool enabled, uint32_t log_interval_sec)
+    {
+       auto& profiler = _app.chain_database()->get_execution_profiler();
+       profiler.set_log_interval( fc::seconds( log_interval_sec ) );
+       profiler.enable( enabled );
+    }
+
     fc::api<network_broadcast_api> login_api::network_broadcast()const
     {
        FC_ASSERT(_network_broadcast_api);
@@ -234,6 +260,12 @@ namespace graphene { namespace app {
        return *_crypto_api;
     }
 
+    fc::api<profiling_api> login_api::profiling() const
+    {
+       FC_ASSERT(_profiling_api);
+       return *_profiling_api;
+    }
+
     fc::api<graphene::debug_witness::debug_api> login_api::debug() const
     {
        FC_ASSERT(_debug_api);
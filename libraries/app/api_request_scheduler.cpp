@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/app/api_request_scheduler.hpp>
+#include <graphene/app/api.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/variant_object.hpp>
+
+namespace graphene { namespace app {
+
+namespace {
+
+   // Calls that walk large parts of the database or return many objects. Everything else costs 1.
+   const std::map<std::string, uint32_t> default_method_costs = {
+      { "get_blocks",                            10 },
+      { "get_blocks_with_virtual_operations",    10 },
+      { "get_full_accounts",                     5 },
+      { "get_full_accounts_page",                10 },
+      { "get_vaults_info_page",                  10 },
+      { "get_queue_submissions_with_pos_page",   10 },
+      { "get_reward_queue",                      20 },
+      { "get_total_cycles",                      50 },
+      { "get_top_dasc_holders",                  50 },
+      { "get_account_history",                   5 },
+      { "get_relative_account_history",          5 }
+   };
+
+   // Beyond this many distinct method names, statistics are lumped together so clients can't grow the map at will
+   const size_t max_tracked_methods = 256;
+
+   // JSON-RPC server error codes for requests we refuse to run
+   const int64_t request_rejected_error_code = -32001;
+
+   /**
+    * Find the method a request calls and its parameters, whether called directly or through "call" with an api id.
+    * Returns false for anything else, such as a reply to one of our callbacks.
+    */
+   bool describe_request( const fc::variant& request, std::string& method, fc::variants& params )
+   {
+      if( !request.is_object() )
+         return false;
+      const fc::variant_object& request_object = request.get_object();
+      auto method_itr = request_object.find( "method" );
+      if( method_itr == request_object.end() || !method_itr->value().is_string() )
+         return false;
+      method = method_itr->value().get_string();
+      auto params_itr = request_object.find( "params" );
+      if( params_itr != request_object.end() && params_itr->value().is_array() )
+         params = params_itr->value().get_array();
+
+      if( method == "call" )
+      {
+         if( params.size() < 2 || !params[1].is_string() )
+            return false;
+         method = params[1].get_string();
+         if( params.size() >= 3 && params[2].is_array() )
+            params = fc::variants( params[2].get_array() );
+         else
+            params.clear();
+      }
+      return true;
+   }
+
+}
+
+api_request_scheduler::ticket::ticket( api_request_scheduler& scheduler, connection_state& connection,
+                                       std::string method, uint32_t cost )
+   : _scheduler( scheduler ), _connection( connection ), _method( std::move( method ) ), _cost( cost ),
+     _start_time( fc::time_point::now() )
+{
+}
+
+api_request_scheduler::ticket::~ticket()
+{
+   _scheduler.finish( _connection, _method, _cost, fc::time_point::now() - _start_time );
+}
+
+api_request_scheduler::api_request_scheduler( uint32_t max_cost_in_flight, const std::map<std::string, uint32_t>& method_costs )
+   : _max_cost_in_flight( max_cost_in_flight ), _method_costs( default_method_costs )
+{
+   for( const auto& method_cost : method_costs )
+      _method_costs[method_cost.first] = method_cost.second;
+}
+
+std::shared_ptr<api_request_scheduler::connection_state> api_request_scheduler::open_connection( const api_access_info& access )const
+{
+   auto state = std::make_shared<connection_state>();
+   state->set_access( access );
+   return state;
+}
+
+uint32_t api_request_scheduler::estimate_cost( const std::string& method, const fc::variants& params )const
+{
+   auto itr = _method_costs.find( method );
+   const uint64_t base_cost = itr != _method_costs.end() ? itr->second : 1;
+
+   // batch calls cost more the more they ask for
+   size_t largest_array = 0;
+   for( const fc::variant& param : params )
+      if( param.is_array() )
+         largest_array = std::max( largest_array, param.get_array().size() );
+
+   return uint32_t( std::min<uint64_t>( base_cost * ( 1 + largest_array / 100 ), std::numeric_limits<uint32_t>::max() ) );
+}
+
+bool api_request_scheduler::can_run( const connection_state& connection, uint32_t cost )const
+{
+   if( connection._access.max_concurrent_requests > 0 &&
+       connection._requests_in_flight >= connection._access.max_concurrent_requests )
+      return false;
+   // a request costing more than the whole budget still gets to run, alone
+   return _cost_in_flight == 0 || uint64_t( _cost_in_flight ) + cost <= _max_cost_in_flight;
+}
+
+void api_request_scheduler::start( connection_state& connection, uint32_t cost )
+{
+   ++connection._requests_in_flight;
+   ++_requests_in_flight;
+   _cost_in_flight += cost;
+}
+
+void api_request_scheduler::finish( connection_state& connection, const std::string& method, uint32_t cost,
+                                    fc::microseconds execution_time )
+{
+   --connection._requests_in_flight;
+   --_requests_in_flight;
+   _cost_in_flight -= cost;
+   stats_for( method ).total_execution_time_us += execution_time.count();
+   admit_queued();
+}
+
+void api_request_scheduler::admit_queued()
+{
+   for( auto itr = _queue.begin(); itr != _queue.end(); )
+   {
+      queued_request& request = itr->second;
+      if( !can_run( *request.connection, request.cost ) )
+      {
+         // only requests held back by their own connection's limit may be overtaken
+         if( request.connection->_access.max_concurrent_requests == 0 ||
+             request.connection->_requests_in_flight < request.connection->_access.max_concurrent_requests )
+            break;
+         ++itr;
+         continue;
+      }
+      start( *request.connection, request.cost );
+      --request.connection->_requests_queued;
+      request.admitted->set_value();
+      itr = _queue.erase( itr );
+   }
+}
+
+api_method_stats& api_request_scheduler::stats_for( const std::string& method )
+{
+   auto itr = _method_stats.find( method );
+   if( itr != _method_stats.end() )
+      return itr->second;
+   if( _method_stats.size() >= max_tracked_methods )
+      return _method_stats["other"];
+   return _method_stats[method];
+}
+
+std::unique_ptr<api_request_scheduler::ticket> api_request_scheduler::admit( connection_state& connection,
+                                                                              const std::string& method,
+                                                                              const fc::variants& params )
+{
+   const uint32_t cost = estimate_cost( method, params );
+   if( _queue.empty() && can_run( connection, cost ) )
+   {
+      start( connection, cost );
+      ++stats_for( method ).admitted;
+      return std::unique_ptr<ticket>( new ticket( *this, connection, method, cost ) );
+   }
+
+   if( connection._requests_queued >= connection._access.max_queued_requests )
+   {
+      ++stats_for( method ).rejected;
+      FC_THROW( "Server busy, too many requests queued on this connection" );
+   }
+
+   const auto key = std::make_pair( connection._access.priority, _next_sequence++ );
+   fc::promise<void>::ptr admitted( new fc::promise<void>( "api_request_admitted" ) );
+   _queue.emplace( key, queued_request{ &connection, cost, admitted } );
+   ++connection._requests_queued;
+   admit_queued();
+
+   const fc::time_point queued_time = fc::time_point::now();
+   // once the request has left the queue it has been started, even if the wait below ends with an exception
+   auto withdraw = [&]() -> bool {
+      auto itr = _queue.find( key );
+      if( itr == _queue.end() )
+         return false;
+      _queue.erase( itr );
+      --connection._requests_queued;
+      return true;
+   };
+   try
+   {
+      admitted->wait( fc::milliseconds( connection._access.max_queue_time_ms ) );
+   }
+   catch( const fc::timeout_exception& )
+   {
+      if( withdraw() )
+      {
+         ++stats_for( method ).timed_out;
+         FC_THROW( "Server busy, request not admitted within ${ms} ms", ("ms", connection._access.max_queue_time_ms) );
+      }
+   }
+   catch( ... )
+   {
+      if( !withdraw() )
+         finish( connection, method, cost, fc::microseconds() );
+      throw;
+   }
+
+   api_method_stats& stats = stats_for( method );
+   const uint64_t queue_time = ( fc::time_point::now() - queued_time ).count();
+   ++stats.admitted;
+   stats.total_queue_time_us += queue_time;
+   stats.max_queue_time_us = std::max( stats.max_queue_time_us, queue_time );
+   return std::unique_ptr<ticket>( new ticket( *this, connection, method, cost ) );
+}
+
+api_request_scheduler_stats api_request_scheduler::get_stats()const
+{
+   api_request_scheduler_stats result;
+   result.max_cost_in_flight = _max_cost_in_flight;
+   result.cost_in_flight = _cost_in_flight;
+   result.requests_in_flight = _requests_in_flight;
+   result.requests_queued = uint32_t( _queue.size() );
+   result.methods = _method_stats;
+   return result;
+}
+
+scheduled_websocket_api_connection::scheduled_websocket_api_connection( fc::http::websocket_connection& c,
+                                                                        uint32_t max_conversion_depth,
+                                                                        api_request_scheduler& scheduler,
+                                                                        std::shared_ptr<login_api> login )
+   : fc::rpc::websocket_api_connection( c, max_conversion_depth ),
+     _scheduler( scheduler ),
+     _login( std::move( login ) ),
+     _state( scheduler.open_connection( _login->get_access_info() ? *_login->get_access_info() : api_access_info() ) )
+{
+   // replace the handlers installed by websocket_api_connection
+   _connection.on_message_handler( [this]( const std::string& msg ) { handle_message( msg, true ); } );
+   _connection.on_http_handler( [this]( const std::string& msg ) { return handle_message( msg, false ); } );
+}
+
+fc::variant scheduled_websocket_api_connection::make_rejection_reply( const fc::variant& id, const fc::exception& e )
+{
+   fc::mutable_variant_object reply;
+   reply( "id", id )
+        ( "jsonrpc", "2.0" )
+        ( "error", fc::mutable_variant_object( "code", request_rejected_error_code )( "message", e.to_string() ) );
+   return fc::variant( reply );
+}
+
+std::string scheduled_websocket_api_connection::handle_message( const std::string& message, bool send_message )
+{
+   fc::variant request;
+   std::string method;
+   fc::variants params;
+   try
+   {
+      request = fc::json::from_string( message, fc::json::legacy_parser, _max_conversion_depth );
+   }
+   catch( const fc::exception& )
+   {
+      // let websocket_api_connection report the error
+      return on_message( message, send_message );
+   }
+   if( !describe_request( request, method, params ) )
+      return on_message( message, send_message );
+
+   // keep the state alive while waiting, even if the connection goes away meanwhile
+   auto state = _state;
+   std::unique_ptr<api_request_scheduler::ticket> ticket;
+   try
+   {
+      ticket = _scheduler.admit( *state, method, params );
+   }
+   catch( const fc::canceled_exception& )
+   {
+      throw;
+   }
+   catch( const fc::exception& e )
+   {
+      const fc::variant_object& request_object = request.get_object();
+      auto id_itr = request_object.find( "id" );
+      if( id_itr == request_object.end() )
+         return std::string();
+      std::string reply_string = fc::json::to_string( make_rejection_reply( id_itr->value(), e ) );
+      if( send_message )
+         _connection.send_message( reply_string );
+      return reply_string;
+   }
+
+   std::string result = on_message( message, send_message );
+   if( method == "login" && _login->get_access_info() )
+      state->set_access( *_login->get_access_info() );
+   return result;
+}
+
+} }
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/app/api_result_cache.hpp>
+
+namespace graphene { namespace app {
+
+api_result_cache::api_result_cache( graphene::chain::database& db, uint64_t max_size_in_bytes )
+   : _db( db )
+{
+   _stats.max_size_in_bytes = max_size_in_bytes;
+   _applied_block_connection = _db.applied_block.connect( [this]( const graphene::chain::signed_block& ) {
+      std::lock_guard<std::mutex> guard( _mutex );
+      reset( _db.head_block_id() );
+   } );
+}
+
+api_result_cache_stats api_result_cache::get_stats()const
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   api_result_cache_stats result = _stats;
+   result.entries = _entries.size();
+   return result;
+}
+
+void api_result_cache::reset( const graphene::chain::block_id_type& head_block_id )
+{
+   _entries.clear();
+   _insertion_order.clear();
+   _stats.size_in_bytes = 0;
+   _head_block_id = head_block_id;
+}
+
+void api_result_cache::store( const graphene::chain::block_id_type& head_block_id, const std::string& key,
+                              std::shared_ptr<const void> result, uint64_t size_in_bytes )
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   // the head moved on while the result was computed, or it would never fit
+   if( head_block_id != _head_block_id || size_in_bytes > _stats.max_size_in_bytes )
+      return;
+   if( _entries.find( key ) != _entries.end() )
+      return;
+
+   while( _stats.size_in_bytes + size_in_bytes > _stats.max_size_in_bytes )
+   {
+      auto oldest = _entries.find( _insertion_order.front() );
+      _stats.size_in_bytes -= oldest->second.size_in_bytes;
+      _entries.erase( oldest );
+      _insertion_order.pop_front();
+      ++_stats.evictions;
+   }
+
+   _insertion_order.push_back( key );
+   _entries.emplace( key, entry{ std::move( result ), size_in_bytes } );
+   _stats.size_in_bytes += size_in_bytes;
+}
+
+} } // graphene::app
@@ -253,14 +253,9 @@ std::vector<fc::ip::endpoint> application_impl::resolve_string_to_ip_endpoints(c
 
 void application_impl::new_connection( const fc::http::websocket_connection_ptr& c )
 {
-   auto wsc = std::make_shared<fc::rpc::websocket_api_connection>(*c, GRAPHENE_NET_MAX_NESTED_OBJECTS);
    auto login = std::make_shared<graphene::app::login_api>( std::ref(*_self) );
    login->enable_api("database_api");
 
-   wsc->register_api(login->database());
-   wsc->register_api(fc::api<graphene::app::login_api>(login));
-   c->set_session_data( wsc );
-
    std::string username = "*";
    std::string password = "*";
 
@@ -281,6 +276,18 @@ void application_impl::new_connection( const fc::http::websocket_connection_ptr&
    }
 
    login->login(username, password);
+
+   // logged in first, so the scheduler knows the role the connection's requests run under
+   std::shared_ptr<fc::rpc::websocket_api_connection> wsc;
+   if( _app_options.api_request_scheduler )
+      wsc = std::make_shared<scheduled_websocket_api_connection>( *c, GRAPHENE_NET_MAX_NESTED_OBJECTS,
+                                                                  *_app_options.api_request_scheduler, login );
+   else
+      wsc = std::make_shared<fc::rpc::websocket_api_connection>(*c, GRAPHENE_NET_MAX_NESTED_OBJECTS);
+
+   wsc->register_api(login->database());
+   wsc->register_api(fc::api<graphene::app::login_api>(login));
+   c->set_session_data( wsc );
 }
 
 void application_impl::reset_websocket_server()
@@ -392,6 +399,16 @@ void application_impl::startup()
    }
    _chain_db->add_checkpoints( loaded_checkpoints );
 
+   if( _options->count("execution-profile-log-interval") )
+   {
+      auto& profiler = _chain_db->get_execution_profiler();
+      profiler.set_log_interval( fc::seconds( _options->at("execution-profile-log-interval").as<uint32_t>() ) );
+      profiler.enable( true );
+   }
+
+   if( _options->count("transaction-precompute-threads") )
+      _chain_db->set_transaction_precompute_threads( _options->at("transaction-precompute-threads").as<uint16_t>() );
+
    if( _options->count("replay-blockchain") )
       _chain_db->wipe( _data_dir / "blockchain", false );
 
@@ -411,9 +428,45 @@ void application_impl::startup()
       _force_validate = true;
    }
 
+   if( _options->count("verify-vote-tally") )
+   {
+      ilog( "Vote tallies will be verified against a full recount at maintenance" );
+      _chain_db->set_vote_tally_verification( true );
+   }
+
    if( _active_plugins.find( "market_history" ) != _active_plugins.end() )
       _app_options.has_market_history_plugin = true;
 
+   if( _options->count("api-read-threads") )
+   {
+      const uint16_t read_threads = _options->at("api-read-threads").as<uint16_t>();
+      for( uint16_t i = 0; i < read_threads; ++i )
+         _app_options.api_read_threads.push_back( std::make_shared<fc::thread>( "api_read_" + fc::to_string(i) ) );
+      if( read_threads > 0 )
+      {
+         _chain_db->enable_concurrent_reads( true );
+         ilog( "Serving read-only API calls on ${n} thread(s)", ("n", read_threads) );
+      }
+   }
+
+   if( _options->count("api-result-cache-size") && _options->at("api-result-cache-size").as<uint32_t>() > 0 )
+   {
+      const uint64_t cache_size = uint64_t( _options->at("api-result-cache-size").as<uint32_t>() ) * 1024 * 1024;
+      _app_options.api_result_cache = std::make_shared<api_result_cache>( *_chain_db, cache_size );
+      ilog( "Caching database_api results, up to ${n} bytes", ("n", cache_size) );
+   }
+
+   if( _options->count("api-max-cost-in-flight") && _options->at("api-max-cost-in-flight").as<uint32_t>() > 0 )
+   {
+      const uint32_t max_cost_in_flight = _options->at("api-max-cost-in-flight").as<uint32_t>();
+      std::map<std::string, uint32_t> method_costs;
+      if( _options->count("api-method-costs") )
+         method_costs = fc::json::from_string( _options->at("api-method-costs").as<string>() )
+                           .as<std::map<std::string, uint32_t>>( 2 );
+      _app_options.api_request_scheduler = std::make_shared<api_request_scheduler>( max_cost_in_flight, method_costs );
+      ilog( "Scheduling API requests, up to a cost of ${n} in flight", ("n", max_cost_in_flight) );
+   }
+
    if( _options->count("api-access") ) {
 
       if(fc::exists(_options->at("api-access").as<boost::filesystem::path>()))
@@ -511,6 +564,9 @@ bool application_impl::handle_block(const graphene::net::block_message& blk_msg,
    FC_ASSERT( (latency.count()/1000) > -5000, "Rejecting block with timestamp in the future" );
 
    try {
+      // validated on the worker threads here, before the chain starts applying the block
+      _chain_db->precompute_transactions( blk_msg.block );
+
       // TODO: in the case where this block is valid but on a fork that's too old for us to switch to,
       // you can help the network code out by throwing a block_older_than_undo_history exception.
       // when the net code sees that, it will stop trying to push blocks from that chain, but
@@ -941,6 +997,20 @@ void application::set_program_options(boost::program_options::options_descriptio
          ("api-access", bpo::value<boost::filesystem::path>(), "JSON file specifying API permissions")
          ("plugins", bpo::value<string>(), "Space-separated list of plugins to activate")
          ("io-threads", bpo::value<uint16_t>()->implicit_value(0), "Number of IO threads, default to 0 for auto-configuration")
+         ("api-read-threads", bpo::value<uint16_t>(),
+          "Number of threads that serve expensive read-only API calls concurrently with block processing, default 0 serves them on the main thread")
+         ("execution-profile-log-interval", bpo::value<uint32_t>(),
+          "Profile operation evaluation and block application from startup and log a summary this many seconds apart, 0 profiles without logging")
+         ("transaction-precompute-threads", bpo::value<uint16_t>(),
+          "Number of threads that validate the transactions of a received block before it is pushed, default 0 validates them while applying")
+         ("api-result-cache-size", bpo::value<uint32_t>(),
+          "Size limit in MiB of the cache of database_api results shared by all connections, default 0 disables the cache")
+         ("api-max-cost-in-flight", bpo::value<uint32_t>(),
+          "Total estimated cost of API requests allowed to run at once, the rest are queued by the priority and within "
+          "the limits of their api-access role; default 0 runs every request as it arrives")
+         ("api-method-costs", bpo::value<string>(),
+          "JSON object of API method names to their estimated cost, overriding the built-in estimates; methods not "
+          "listed cost 1")
          // TODO uncomment this when GUI is ready
          //("enable-subscribe-to-all", bpo::value<bool>()->implicit_value(false),
          // "Whether allow API clients to subscribe to universal object creation and removal events")
@@ -954,6 +1024,7 @@ void application::set_program_options(boost::program_options::options_descriptio
          ("replay-blockchain", "Rebuild object graph by replaying all blocks")
          ("resync-blockchain", "Delete all blocks and re-sync with network from scratch")
          ("force-validate", "Force validation of all transactions")
+         ("verify-vote-tally", "Recount all votes at maintenance and check them against the incrementally maintained tally")
          ("genesis-timestamp", bpo::value<uint32_t>(),
           "Replace timestamp from genesis.json with current time plus this many seconds (experts only!)")
          ;
@@ -40,6 +40,7 @@
 #include <boost/rational.hpp>
 #include <boost/multiprecision/cpp_int.hpp>
 
+#include <atomic>
 #include <cctype>
 #include <cmath>
 
@@ -79,6 +80,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
                                                                                               uint32_t count,
                                                                                               std::vector<uint16_t>& virtual_operation_ids) const;
       processed_transaction get_transaction( uint32_t block_num, uint32_t trx_in_block )const;
+      optional<block_access_batches> get_block_access_batches( uint32_t block_num )const;
 
       // Globals
       chain_property_object get_chain_properties()const;
@@ -87,6 +89,8 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       chain_id_type get_chain_id()const;
       dynamic_global_property_object get_dynamic_global_properties()const;
       optional<total_cycles_res> get_total_cycles() const;
+      optional<api_result_cache_stats> get_api_result_cache_stats() const;
+      optional<api_request_scheduler_stats> get_api_request_scheduler_stats() const;
 
       // Keys
       vector<vector<account_id_type>> get_key_references( vector<public_key_type> key )const;
@@ -94,6 +98,9 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       // Accounts
       vector<optional<account_object>> get_accounts(const vector<account_id_type>& account_ids)const;
       std::map<string,full_account> get_full_accounts( const vector<string>& names_or_ids, bool subscribe );
+      std::map<string,full_account> get_full_accounts_with_fields( const vector<string>& names_or_ids,
+                                                                   const vector<string>& fields )const;
+      full_accounts_page get_full_accounts_page( account_id_type start, uint32_t limit, const vector<string>& fields )const;
       optional<account_object> get_account_by_name( string name )const;
       vector<account_id_type> get_account_references( account_id_type account_id )const;
       vector<optional<account_object>> lookup_account_names(const vector<string>& account_names)const;
@@ -186,11 +193,13 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       acc_id_queue_subs_w_pos_res get_queue_submissions_with_pos(account_id_type account_id) const;
       vector<acc_id_queue_subs_w_pos_res>
           get_queue_submissions_with_pos_for_accounts(vector<account_id_type> ids) const;
+      queue_submissions_with_pos_page get_queue_submissions_with_pos_page(account_id_type start, uint32_t limit) const;
       uint32_t get_reward_queue_size() const;
 
       // Vault info:
       optional<vault_info_res> get_vault_info(account_id_type vault_id) const;
       vector<acc_id_vault_info_res> get_vaults_info(vector<account_id_type> vault_ids) const;
+      vaults_info_page get_vaults_info_page(account_id_type start, uint32_t limit) const;
 
       optional<cycle_price> calculate_cycle_price(share_type cycle_amount, asset_id_type asset_id) const;
 
@@ -214,6 +223,8 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       vector<last_price_object> get_last_prices() const;
       vector<external_price_object> get_external_prices() const;
 
+      /// Object ids must be passed as object_id_type, that is what handle_object_changed() looks up; a typed
+      /// object_id<> packs differently and would never match
       template<typename T>
       void subscribe_to_item( const T& i )const
       {
@@ -389,7 +400,51 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       database_access_layer _dal;
       const application_options* _app_options = nullptr;
 
+      // Parts of a full_account that are only looked up when asked for
+      enum full_account_fields : uint32_t
+      {
+         statistics_field       = 1 << 0,
+         referrer_names_field   = 1 << 1,
+         cashback_balance_field = 1 << 2,
+         balances_field         = 1 << 3,
+         vesting_balances_field = 1 << 4,
+         limit_orders_field     = 1 << 5,
+         call_orders_field      = 1 << 6,
+         proposals_field        = 1 << 7,
+         all_full_account_fields = ( 1 << 8 ) - 1
+      };
+      static uint32_t parse_full_account_fields( const vector<string>& fields );
+      const account_object* find_account_by_name_or_id( const string& account_name_or_id )const;
+      full_account make_full_account( const account_object& account, uint32_t fields )const;
+
+      /**
+       * Run a read-only query on one of the api read threads if there are any, otherwise right here.
+       * The query must not touch subscription state, which is only safe on the main thread.
+       */
+      template<typename Query>
+      auto run_read_only( Query&& query )const -> decltype( query() )
+      {
+         if( !_app_options || _app_options->api_read_threads.empty() )
+            return query();
+         const auto& threads = _app_options->api_read_threads;
+         const auto& thread = threads[_next_read_thread++ % threads.size()];
+         return thread->async( [this, &query]() { return _db.with_read_lock( query ); }, "api_read_query" ).wait();
+      }
+
+      /**
+       * Look the result up in the shared result cache if it is enabled, otherwise just compute it.
+       */
+      template<typename Result, typename Compute>
+      Result cached( const std::string& method, const fc::variants& params, Compute&& compute )const
+      {
+         if( !_app_options || !_app_options->api_result_cache )
+            return compute();
+         return _app_options->api_result_cache->get_or_compute<Result>( method, params, std::forward<Compute>( compute ) );
+      }
+
    private:
+      mutable std::atomic<uint32_t> _next_read_thread{0};
+
       template<typename IterStart, typename IterEnd>
       void func_re_pack(IterStart helper_itr, IterEnd end, std::vector<agregated_limit_orders_with_same_price_collection>& ret, uint32_t limit_group, uint32_t limit_per_group) const;
 };
@@ -605,6 +660,26 @@ processed_transaction database_api::get_transaction( uint32_t block_num, uint32_
    return my->get_transaction( block_num, trx_in_block );
 }
 
+optional<block_access_batches> database_api::get_block_access_batches( uint32_t block_num )const
+{
+   return my->get_block_access_batches( block_num );
+}
+
+optional<block_access_batches> database_api_impl::get_block_access_batches( uint32_t block_num )const
+{
+   auto block = _db.fetch_block_by_number( block_num );
+   if( !block )
+      return {};
+
+   block_access_batches result;
+   result.footprints.resize( block->transactions.size() );
+   for( size_t i = 0; i < block->transactions.size(); ++i )
+      transaction_get_access_footprint( block->transactions[i], result.footprints[i] );
+   result.batches = build_conflict_free_batches( result.footprints,
+                                                 _db.get_dynamic_global_properties().fee_pool_account_id );
+   return result;
+}
+
 optional<signed_transaction> database_api::get_recent_transaction_by_id( const transaction_id_type& id )const
 {
    try {
@@ -679,7 +754,9 @@ dynamic_global_property_object database_api_impl::get_dynamic_global_properties(
 }
 
 optional<total_cycles_res> database_api::get_total_cycles() const {
-    return my->get_total_cycles();
+    return my->cached<optional<total_cycles_res>>( "get_total_cycles", {}, [this]() {
+       return my->run_read_only( [this]() { return my->get_total_cycles(); } );
+    } );
 }
 
 optional<total_cycles_res> database_api_impl::get_total_cycles() const {
@@ -701,6 +778,30 @@ optional<total_cycles_res> database_api_impl::get_total_cycles() const {
     return result;
 }
 
+optional<api_result_cache_stats> database_api::get_api_result_cache_stats() const
+{
+   return my->get_api_result_cache_stats();
+}
+
+optional<api_result_cache_stats> database_api_impl::get_api_result_cache_stats() const
+{
+   if( !_app_options || !_app_options->api_result_cache )
+      return {};
+   return _app_options->api_result_cache->get_stats();
+}
+
+optional<api_request_scheduler_stats> database_api::get_api_request_scheduler_stats() const
+{
+   return my->get_api_request_scheduler_stats();
+}
+
+optional<api_request_scheduler_stats> database_api_impl::get_api_request_scheduler_stats() const
+{
+   if( !_app_options || !_app_options->api_request_scheduler )
+      return {};
+   return _app_options->api_request_scheduler->get_stats();
+}
+
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
 // Keys                                                             //
@@ -789,7 +890,7 @@ vector<optional<account_object>> database_api_impl::get_accounts(const vector<ac
                   [this](account_id_type id) -> optional<account_object> {
       if(auto o = _db.find(id))
       {
-         subscribe_to_item( id );
+         subscribe_to_item( object_id_type(id) );
          return *o;
       }
       return {};
@@ -799,7 +900,10 @@ vector<optional<account_object>> database_api_impl::get_accounts(const vector<ac
 
 std::map<string,full_account> database_api::get_full_accounts( const vector<string>& names_or_ids, bool subscribe )
 {
-   return my->get_full_accounts( names_or_ids, subscribe );
+   // subscribing updates the subscription filter, so only plain lookups can leave the main thread
+   if( subscribe )
+      return my->get_full_accounts( names_or_ids, subscribe );
+   return my->run_read_only( [&]() { return my->get_full_accounts( names_or_ids, false ); } );
 }
 
 std::map<std::string, full_account> database_api_impl::get_full_accounts( const vector<std::string>& names_or_ids, bool subscribe)
@@ -809,16 +913,7 @@ std::map<std::string, full_account> database_api_impl::get_full_accounts( const
 
    for (const std::string& account_name_or_id : names_or_ids)
    {
-      const account_object* account = nullptr;
-      if (std::isdigit(account_name_or_id[0]))
-         account = _db.find(fc::variant(account_name_or_id, 1).as<account_id_type>(1));
-      else
-      {
-         const auto& idx = _db.get_index_type<account_index>().indices().get<by_name>();
-         auto itr = idx.find(account_name_or_id);
-         if (itr != idx.end())
-            account = &*itr;
-      }
+      const account_object* account = find_account_by_name_or_id( account_name_or_id );
       if (account == nullptr)
          continue;
 
@@ -830,67 +925,163 @@ std::map<std::string, full_account> database_api_impl::get_full_accounts( const
          }
       }
 
-      // fc::mutable_variant_object full_account;
-      full_account acnt;
-      acnt.account = *account;
-      acnt.statistics = account->statistics(_db);
-      acnt.registrar_name = account->registrar(_db).name;
-      acnt.referrer_name = account->referrer(_db).name;
-      acnt.lifetime_referrer_name = account->lifetime_referrer(_db).name;
-      acnt.votes.clear();
-
-      // Add the account itself, its statistics object, cashback balance, and referral account names
-      /*
-      full_account("account", *account)("statistics", account->statistics(_db))
-            ("registrar_name", account->registrar(_db).name)("referrer_name", account->referrer(_db).name)
-            ("lifetime_referrer_name", account->lifetime_referrer(_db).name);
-            */
-      if (account->cashback_vb)
+      results[account_name_or_id] = make_full_account( *account, all_full_account_fields );
+   }
+   return results;
+}
+
+std::map<string,full_account> database_api::get_full_accounts_with_fields( const vector<string>& names_or_ids,
+                                                                           const vector<string>& fields )const
+{
+   return my->run_read_only( [&]() { return my->get_full_accounts_with_fields( names_or_ids, fields ); } );
+}
+
+std::map<string,full_account> database_api_impl::get_full_accounts_with_fields( const vector<string>& names_or_ids,
+                                                                                const vector<string>& fields )const
+{
+   const uint32_t fields_to_fill = parse_full_account_fields( fields );
+   std::map<std::string, full_account> results;
+   for( const std::string& account_name_or_id : names_or_ids )
+   {
+      const account_object* account = find_account_by_name_or_id( account_name_or_id );
+      if( account != nullptr )
+         results[account_name_or_id] = make_full_account( *account, fields_to_fill );
+   }
+   return results;
+}
+
+full_accounts_page database_api::get_full_accounts_page( account_id_type start, uint32_t limit, const vector<string>& fields )const
+{
+   return my->run_read_only( [&]() { return my->get_full_accounts_page( start, limit, fields ); } );
+}
+
+full_accounts_page database_api_impl::get_full_accounts_page( account_id_type start, uint32_t limit, const vector<string>& fields )const
+{
+   FC_ASSERT( limit <= 100 );
+   const uint32_t fields_to_fill = parse_full_account_fields( fields );
+
+   full_accounts_page page;
+   page.accounts.reserve( limit );
+   const auto& accounts_by_id = _db.get_index_type<account_index>().indices().get<by_id>();
+   for( auto itr = accounts_by_id.lower_bound( start ); itr != accounts_by_id.end(); ++itr )
+   {
+      if( page.accounts.size() == limit )
       {
-         acnt.cashback_balance = account->cashback_balance(_db);
+         page.next = itr->get_id();
+         break;
       }
-      // Add the account's proposals
+      page.accounts.emplace_back( make_full_account( *itr, fields_to_fill ) );
+   }
+   return page;
+}
+
+uint32_t database_api_impl::parse_full_account_fields( const vector<string>& fields )
+{
+   static const std::map<string, uint32_t> field_names = {
+      { "statistics",       statistics_field },
+      { "referrer_names",   referrer_names_field },
+      { "cashback_balance", cashback_balance_field },
+      { "balances",         balances_field },
+      { "vesting_balances", vesting_balances_field },
+      { "limit_orders",     limit_orders_field },
+      { "call_orders",      call_orders_field },
+      { "proposals",        proposals_field }
+   };
+
+   if( fields.empty() )
+      return all_full_account_fields;
+   uint32_t result = 0;
+   for( const string& field : fields )
+   {
+      auto itr = field_names.find( field );
+      FC_ASSERT( itr != field_names.end(), "Unknown full account field ${field}", ("field", field) );
+      result |= itr->second;
+   }
+   return result;
+}
+
+const account_object* database_api_impl::find_account_by_name_or_id( const string& account_name_or_id )const
+{
+   if( account_name_or_id.empty() )
+      return nullptr;
+   if( std::isdigit( account_name_or_id[0] ) )
+      return _db.find( fc::variant( account_name_or_id, 1 ).as<account_id_type>( 1 ) );
+   const auto& idx = _db.get_index_type<account_index>().indices().get<by_name>();
+   auto itr = idx.find( account_name_or_id );
+   return itr != idx.end() ? &*itr : nullptr;
+}
+
+full_account database_api_impl::make_full_account( const account_object& account, uint32_t fields )const
+{
+   full_account acnt;
+   acnt.account = account;
+   if( fields & statistics_field )
+      acnt.statistics = account.statistics(_db);
+   if( fields & referrer_names_field )
+   {
+      acnt.registrar_name = account.registrar(_db).name;
+      acnt.referrer_name = account.referrer(_db).name;
+      acnt.lifetime_referrer_name = account.lifetime_referrer(_db).name;
+   }
+
+   if( ( fields & cashback_balance_field ) && account.cashback_vb )
+   {
+      acnt.cashback_balance = account.cashback_balance(_db);
+   }
+
+   // Add the account's proposals
+   if( fields & proposals_field )
+   {
       const auto& proposal_idx = _db.get_index_type<proposal_index>();
       const auto& pidx = dynamic_cast<const primary_index<proposal_index>&>(proposal_idx);
       const auto& proposals_by_account = pidx.get_secondary_index<graphene::chain::required_approval_index>();
-      auto  required_approvals_itr = proposals_by_account._account_to_proposals.find( account->id );
+      auto  required_approvals_itr = proposals_by_account._account_to_proposals.find( account.id );
       if( required_approvals_itr != proposals_by_account._account_to_proposals.end() )
       {
          acnt.proposals.reserve( required_approvals_itr->second.size() );
          for( auto proposal_id : required_approvals_itr->second )
             acnt.proposals.push_back( proposal_id(_db) );
       }
+   }
 
-
-      // Add the account's balances
-      auto balance_range = _db.get_index_type<account_balance_index>().indices().get<by_account_asset>().equal_range(boost::make_tuple(account->id));
-      //vector<account_balance_object> balances;
+   // Add the account's balances
+   if( fields & balances_field )
+   {
+      auto balance_range = _db.get_index_type<account_balance_index>().indices().get<by_account_asset>().equal_range(boost::make_tuple(account.id));
       std::for_each(balance_range.first, balance_range.second,
                     [&acnt](const account_balance_object& balance) {
                        acnt.balances.emplace_back(balance);
                     });
+   }
 
-      // Add the account's vesting balances
-      auto vesting_range = _db.get_index_type<vesting_balance_index>().indices().get<by_account>().equal_range(account->id);
+   // Add the account's vesting balances
+   if( fields & vesting_balances_field )
+   {
+      auto vesting_range = _db.get_index_type<vesting_balance_index>().indices().get<by_account>().equal_range(account.id);
       std::for_each(vesting_range.first, vesting_range.second,
                     [&acnt](const vesting_balance_object& balance) {
                        acnt.vesting_balances.emplace_back(balance);
                     });
+   }
 
-      // Add the account's orders
-      auto order_range = _db.get_index_type<limit_order_index>().indices().get<by_account>().equal_range(account->id);
+   // Add the account's orders
+   if( fields & limit_orders_field )
+   {
+      auto order_range = _db.get_index_type<limit_order_index>().indices().get<by_account>().equal_range(account.id);
       std::for_each(order_range.first, order_range.second,
                     [&acnt] (const limit_order_object& order) {
                        acnt.limit_orders.emplace_back(order);
                     });
-      auto call_range = _db.get_index_type<call_order_index>().indices().get<by_account>().equal_range(account->id);
+   }
+   if( fields & call_orders_field )
+   {
+      auto call_range = _db.get_index_type<call_order_index>().indices().get<by_account>().equal_range(account.id);
       std::for_each(call_range.first, call_range.second,
                     [&acnt] (const call_order_object& call) {
                        acnt.call_orders.emplace_back(call);
                     });
-      results[account_name_or_id] = acnt;
    }
-   return results;
+   return acnt;
 }
 
 optional<account_object> database_api::get_account_by_name( string name )const
@@ -963,7 +1154,7 @@ map<string,account_id_type> database_api_impl::lookup_accounts(const string& low
    {
       result.insert(make_pair(itr->name, itr->get_id()));
       if( limit == 1 )
-         subscribe_to_item( itr->get_id() );
+         subscribe_to_item( object_id_type(itr->get_id()) );
    }
 
    return result;
@@ -1181,7 +1372,7 @@ vector<optional<asset_object>> database_api_impl::get_assets(const vector<asset_
                   [this](asset_id_type id) -> optional<asset_object> {
       if(auto o = _db.find(id))
       {
-         subscribe_to_item( id );
+         subscribe_to_item( object_id_type(id) );
          return *o;
       }
       return {};
@@ -1818,7 +2009,9 @@ bool database_api_impl::check_issued_webeur(const string& unique_id) const
 
 order_book database_api::get_order_book( const string& base, const string& quote, unsigned limit )const
 {
-   return my->get_order_book( base, quote, limit);
+   return my->cached<order_book>( "get_order_book", { fc::variant(base), fc::variant(quote), fc::variant(limit) }, [&]() {
+      return my->get_order_book( base, quote, limit);
+   } );
 }
 
 order_book database_api_impl::get_order_book( const string& base, const string& quote, unsigned limit )const
@@ -2549,7 +2742,7 @@ vector<license_type_object> database_api_impl::get_license_types() const
 
 vector<license_type_object> database_api::get_license_types() const
 {
-   return my->get_license_types();
+   return my->cached<vector<license_type_object>>( "get_license_types", {}, [this]() { return my->get_license_types(); } );
 }
 
 vector<pair<string, license_type_id_type>> database_api::get_license_type_names_ids() const
@@ -2590,7 +2783,7 @@ vector<optional<license_type_object>> database_api_impl::get_license_types(const
                   [this](license_type_id_type id) -> optional<license_type_object> {
       if(auto o = _db.find(id))
       {
-         subscribe_to_item( id );
+         subscribe_to_item( object_id_type(id) );
          return *o;
       }
       return {};
@@ -2734,7 +2927,7 @@ vector<reward_queue_object> database_api_impl::get_reward_queue_by_page(uint32_t
 
 uint32_t database_api::get_reward_queue_size() const
 {
-   return my->get_reward_queue_size();
+   return my->cached<uint32_t>( "get_reward_queue_size", {}, [this]() { return my->get_reward_queue_size(); } );
 }
 
 uint32_t database_api_impl::get_reward_queue_size() const
@@ -2764,6 +2957,18 @@ vector<acc_id_queue_subs_w_pos_res>
     return _dal.get_queue_submissions_with_pos_for_accounts(ids);
 }
 
+queue_submissions_with_pos_page
+    database_api::get_queue_submissions_with_pos_page(account_id_type start, uint32_t limit) const
+{
+    return my->run_read_only( [&]() { return my->get_queue_submissions_with_pos_page(start, limit); } );
+}
+
+queue_submissions_with_pos_page
+    database_api_impl::get_queue_submissions_with_pos_page(account_id_type start, uint32_t limit) const
+{
+    return _dal.get_queue_submissions_with_pos_page(start, limit);
+}
+
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
 // REQUESTS:                                                        //
@@ -2811,6 +3016,16 @@ vector<acc_id_vault_info_res> database_api_impl::get_vaults_info(vector<account_
     return _dal.get_vaults_info(vault_ids);
 }
 
+vaults_info_page database_api::get_vaults_info_page(account_id_type start, uint32_t limit) const
+{
+    return my->run_read_only( [&]() { return my->get_vaults_info_page(start, limit); } );
+}
+
+vaults_info_page database_api_impl::get_vaults_info_page(account_id_type start, uint32_t limit) const
+{
+    return _dal.get_vaults_info_page(start, limit);
+}
+
 optional<cycle_price> database_api::calculate_cycle_price(share_type cycle_amount, asset_id_type asset_id) const
 {
     return my->calculate_cycle_price(cycle_amount, asset_id);
@@ -2832,7 +3047,7 @@ optional<cycle_price> database_api_impl::calculate_cycle_price(share_type cycle_
 
 vector<dasc_holder> database_api::get_top_dasc_holders() const
 {
-    return my->get_top_dasc_holders();
+    return my->run_read_only( [this]() { return my->get_top_dasc_holders(); } );
 }
 
 vector<dasc_holder> database_api_impl::get_top_dasc_holders() const
@@ -3037,7 +3252,9 @@ vector<das33_pledge_holder_object> database_api_impl::get_das33_pledges_by_proje
 
 vector<das33_project_object> database_api::get_das33_projects(const string& lower_bound_name, uint32_t limit) const
 {
-  return my->get_das33_projects(lower_bound_name, limit);
+  return my->cached<vector<das33_project_object>>("get_das33_projects", { fc::variant(lower_bound_name), fc::variant(limit) }, [&]() {
+    return my->get_das33_projects(lower_bound_name, limit);
+  });
 }
 
 
@@ -3067,29 +3284,9 @@ vector<asset> database_api::get_amount_of_assets_pledged_to_project(das33_projec
 
 vector<asset> database_api_impl::get_amount_of_assets_pledged_to_project(das33_project_id_type project) const
 {
-  vector<asset> result;
-  map<asset_id_type, int> index_map;
-
-  auto default_pledge_id = das33_pledge_holder_id_type();
-
-  const auto& pledges = _db.get_index_type<das33_pledge_holder_index>().indices().get<by_project>();
-  for( auto itr = pledges.lower_bound(project); itr != pledges.upper_bound(project); ++itr )
-  {
-   if (itr->id != default_pledge_id)
-   {
-     if (index_map.find(itr->pledged.asset_id) != index_map.end())
-     {
-       result[index_map[itr->pledged.asset_id]] += itr->pledged;
-     }
-     else
-     {
-       index_map[itr->pledged.asset_id] = result.size();
-       result.emplace_back(itr->pledged);
-     }
-   }
-  }
-
-  return result;
+  const auto& idx = _db.get_index_type<das33_pledge_holder_index>();
+  const auto& pidx = dynamic_cast<const primary_index<das33_pledge_holder_index>&>(idx);
+  return pidx.get_secondary_index<das33_pledge_totals_index>().get_project_totals(project);
 }
 
 das33_project_tokens_amount database_api::get_amount_of_project_tokens_received_for_asset(das33_project_id_type project, asset to_pledge) const
@@ -3150,7 +3347,7 @@ das33_project_tokens_amount database_api_impl::get_amount_of_asset_needed_for_pr
 
 vector<last_price_object> database_api::get_last_prices() const
 {
-  return my->get_last_prices();
+  return my->cached<vector<last_price_object>>("get_last_prices", {}, [this]() { return my->get_last_prices(); });
 }
 
 vector<last_price_object> database_api_impl::get_last_prices() const
@@ -229,6 +229,11 @@ namespace graphene { namespace app {
           */
          std::vector<net::peer_status> get_connected_peers() const;
 
+         /**
+          * @brief Get latency, throughput and request failure statistics of all current connections to peers
+          */
+         std::vector<net::peer_telemetry> get_peer_telemetry() const;
+
          /**
           * @brief Get advanced node parameters, such as desired and max
           *        number of connections
@@ -250,6 +255,32 @@ namespace graphene { namespace app {
       private:
          application& _app;
    };
+
+   /**
+    * @brief The profiling_api class controls and reads the execution profiler of the chain database.
+    */
+   class profiling_api
+   {
+      public:
+         profiling_api(application& a);
+
+         /**
+          * @brief Get the time spent per operation type and per block application step
+          * @return the aggregated samples since profiling was last enabled or reset; empty unless execution
+          * profiling is enabled
+          */
+         execution_profile get_execution_profile() const;
+
+         /**
+          * @brief Switch the execution profiler on or off
+          * @param enabled whether to profile; switching it on starts a new profile
+          * @param log_interval_sec log a summary of the profile this often, 0 for no logging
+          */
+         void set_execution_profiling(bool enabled, uint32_t log_interval_sec);
+
+      private:
+         application& _app;
+   };
    
    class crypto_api
    {
@@ -310,11 +341,15 @@ namespace graphene { namespace app {
          fc::api<network_node_api> network_node()const;
          /// @brief Retrieve the cryptography API
          fc::api<crypto_api> crypto()const;
+         /// @brief Retrieve the profiling API
+         fc::api<profiling_api> profiling()const;
          /// @brief Retrieve the debug API (if available)
          fc::api<graphene::debug_witness::debug_api> debug()const;
 
          /// @brief Called to enable an API, not reflected.
          void enable_api( const string& api_name );
+         /// @brief The api_access role of the last successful login, not reflected.
+         const optional< api_access_info >& get_access_info()const { return _access_info; }
       private:
 
          application& _app;
@@ -323,7 +358,9 @@ namespace graphene { namespace app {
          optional< fc::api<network_node_api> > _network_node_api;
          optional< fc::api<history_api> >  _history_api;
          optional< fc::api<crypto_api> > _crypto_api;
+         optional< fc::api<profiling_api> > _profiling_api;
          optional< fc::api<graphene::debug_witness::debug_api> > _debug_api;
+         optional< api_access_info > _access_info;
    };
 
 }}  // graphene::app
@@ -356,10 +393,15 @@ FC_API(graphene::app::network_node_api,
        (get_info)
        (add_node)
        (get_connected_peers)
+       (get_peer_telemetry)
        (get_potential_peers)
        (get_advanced_node_parameters)
        (set_advanced_node_parameters)
      )
+FC_API(graphene::app::profiling_api,
+       (get_execution_profile)
+       (set_execution_profiling)
+     )
 FC_API(graphene::app::crypto_api,
        (blind_sum)
        (verify_sum)
@@ -375,5 +417,6 @@ FC_API(graphene::app::login_api,
        (history)
        (network_node)
        (crypto)
+       (profiling)
        (debug)
      )
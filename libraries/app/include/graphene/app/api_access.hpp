@@ -36,6 +36,12 @@ struct api_access_info
    std::string password_hash_b64;
    std::string password_salt_b64;
    std::vector< std::string > allowed_apis;
+
+   // Request scheduling, only enforced when api-max-cost-in-flight is set
+   uint32_t priority = 0; ///< queued requests of higher priority roles are admitted first
+   uint32_t max_concurrent_requests = 4; ///< requests of one connection running at the same time
+   uint32_t max_queued_requests = 64; ///< requests of one connection waiting to run, more are rejected
+   uint32_t max_queue_time_ms = 5000; ///< requests not admitted within this time are rejected
 };
 
 struct api_access
@@ -49,6 +55,10 @@ FC_REFLECT( graphene::app::api_access_info,
     (password_hash_b64)
     (password_salt_b64)
     (allowed_apis)
+    (priority)
+    (max_concurrent_requests)
+    (max_queued_requests)
+    (max_queue_time_ms)
    )
 
 FC_REFLECT( graphene::app::api_access,
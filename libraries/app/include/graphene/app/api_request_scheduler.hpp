@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/app/api_access.hpp>
+
+#include <fc/rpc/websocket_api.hpp>
+#include <fc/thread/future.hpp>
+#include <fc/time.hpp>
+#include <fc/variant.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace graphene { namespace app {
+
+   class login_api;
+
+   struct api_method_stats
+   {
+      uint64_t admitted = 0;
+      uint64_t rejected = 0;
+      uint64_t timed_out = 0;
+      uint64_t total_queue_time_us = 0;
+      uint64_t max_queue_time_us = 0;
+      uint64_t total_execution_time_us = 0;
+   };
+
+   struct api_request_scheduler_stats
+   {
+      uint32_t max_cost_in_flight = 0;
+      uint32_t cost_in_flight = 0;
+      uint32_t requests_in_flight = 0;
+      uint32_t requests_queued = 0;
+      std::map<std::string, api_method_stats> methods;
+   };
+
+   /**
+    * Admission control for API requests, shared by all websocket connections.
+    *
+    * Every request is given a cost from a per-method table, scaled up for calls passing large arrays. Requests run
+    * while the total cost of those in flight stays within a configured budget and their connection is below the
+    * concurrency limit of its api_access role; the others wait in a queue ordered by role priority, then by arrival,
+    * and are rejected if they are not admitted within the role's maximum queue time or the connection already has
+    * too many requests queued. A request costing more than the whole budget runs alone.
+    *
+    * All methods must be called from the thread serving the websocket connections.
+    */
+   class api_request_scheduler
+   {
+      public:
+         /// Per-connection state, created when the connection is opened
+         class connection_state
+         {
+            public:
+               /// Apply the limits of the api_access role the connection has logged in with
+               void set_access( const api_access_info& access ) { _access = access; }
+               const api_access_info& get_access()const { return _access; }
+
+            private:
+               friend class api_request_scheduler;
+               api_access_info _access;
+               uint32_t        _requests_in_flight = 0;
+               uint32_t        _requests_queued = 0;
+         };
+
+         /// Held while an admitted request runs, frees its share of the budget when destroyed
+         class ticket
+         {
+            public:
+               ticket( api_request_scheduler& scheduler, connection_state& connection, std::string method, uint32_t cost );
+               ticket( const ticket& ) = delete;
+               ticket& operator=( const ticket& ) = delete;
+               ~ticket();
+
+            private:
+               api_request_scheduler& _scheduler;
+               connection_state&      _connection;
+               std::string            _method;
+               uint32_t               _cost;
+               fc::time_point         _start_time;
+         };
+
+         api_request_scheduler( uint32_t max_cost_in_flight, const std::map<std::string, uint32_t>& method_costs );
+
+         std::shared_ptr<connection_state> open_connection( const api_access_info& access )const;
+
+         /**
+          * Wait until the request may run. Throws if the request is rejected or not admitted in time.
+          */
+         std::unique_ptr<ticket> admit( connection_state& connection, const std::string& method, const fc::variants& params );
+
+         uint32_t estimate_cost( const std::string& method, const fc::variants& params )const;
+
+         api_request_scheduler_stats get_stats()const;
+
+      private:
+         struct queued_request
+         {
+            connection_state*          connection;
+            uint32_t                   cost;
+            fc::promise<void>::ptr     admitted;
+         };
+         /// (priority, arrival) ordered with the highest priority first
+         struct queue_order
+         {
+            bool operator()( const std::pair<uint32_t, uint64_t>& a, const std::pair<uint32_t, uint64_t>& b )const
+            {
+               return a.first != b.first ? a.first > b.first : a.second < b.second;
+            }
+         };
+         typedef std::map<std::pair<uint32_t, uint64_t>, queued_request, queue_order> request_queue;
+
+         bool can_run( const connection_state& connection, uint32_t cost )const;
+         void start( connection_state& connection, uint32_t cost );
+         void finish( connection_state& connection, const std::string& method, uint32_t cost, fc::microseconds execution_time );
+         void admit_queued();
+         api_method_stats& stats_for( const std::string& method );
+
+         uint32_t                                 _max_cost_in_flight;
+         std::map<std::string, uint32_t>          _method_costs;
+         uint32_t                                 _cost_in_flight = 0;
+         uint32_t                                 _requests_in_flight = 0;
+         uint64_t                                 _next_sequence = 0;
+         request_queue                            _queue;
+         std::map<std::string, api_method_stats>  _method_stats;
+   };
+
+   /**
+    * A websocket api connection whose requests go through an api_request_scheduler before they are handled.
+    * A request that is not admitted is answered with a JSON-RPC error.
+    */
+   class scheduled_websocket_api_connection : public fc::rpc::websocket_api_connection
+   {
+      public:
+         scheduled_websocket_api_connection( fc::http::websocket_connection& c, uint32_t max_conversion_depth,
+                                             api_request_scheduler& scheduler, std::shared_ptr<login_api> login );
+
+         /// The JSON-RPC error sent for request @p id when it is not admitted
+         static fc::variant make_rejection_reply( const fc::variant& id, const fc::exception& e );
+
+      private:
+         std::string handle_message( const std::string& message, bool send_message );
+
+         api_request_scheduler&                                   _scheduler;
+         std::shared_ptr<login_api>                               _login;
+         std::shared_ptr<api_request_scheduler::connection_state> _state;
+   };
+
+} }
+
+FC_REFLECT( graphene::app::api_method_stats,
+            (admitted)(rejected)(timed_out)(total_queue_time_us)(max_queue_time_us)(total_execution_time_us) )
+FC_REFLECT( graphene::app::api_request_scheduler_stats,
+            (max_cost_in_flight)(cost_in_flight)(requests_in_flight)(requests_queued)(methods) )
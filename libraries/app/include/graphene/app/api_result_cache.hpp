@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/chain/database.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/variant.hpp>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace graphene { namespace app {
+
+   struct api_result_cache_stats
+   {
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+      uint64_t evictions = 0;
+      uint64_t entries = 0;
+      uint64_t size_in_bytes = 0;
+      uint64_t max_size_in_bytes = 0;
+   };
+
+   /**
+    * Results of database_api calls, shared by all API connections and keyed by method, parameters and head block.
+    *
+    * Everything is dropped when a block is applied or the head block otherwise changes. Within a block a cached
+    * result does not reflect pending transactions pushed after it was computed. The size of an entry is taken to
+    * be the packed size of the result, and the oldest entries are evicted to stay within the configured limit.
+    */
+   class api_result_cache
+   {
+      public:
+         api_result_cache( graphene::chain::database& db, uint64_t max_size_in_bytes );
+
+         /**
+          * Return the cached result of @p method called with @p params at the current head block, calling
+          * @p compute to produce it on a miss. Must be called from the thread that applies blocks.
+          */
+         template<typename Result, typename Compute>
+         Result get_or_compute( const std::string& method, const fc::variants& params, Compute&& compute )
+         {
+            const graphene::chain::block_id_type head_block_id = _db.head_block_id();
+            const std::string key = method + fc::json::to_string( params );
+            {
+               std::lock_guard<std::mutex> guard( _mutex );
+               if( head_block_id != _head_block_id )
+                  reset( head_block_id );
+               auto itr = _entries.find( key );
+               if( itr != _entries.end() )
+               {
+                  ++_stats.hits;
+                  return *std::static_pointer_cast<const Result>( itr->second.result );
+               }
+               ++_stats.misses;
+            }
+
+            auto result = std::make_shared<const Result>( compute() );
+            store( head_block_id, key, result, fc::raw::pack_size( *result ) );
+            return *result;
+         }
+
+         api_result_cache_stats get_stats()const;
+
+      private:
+         struct entry
+         {
+            std::shared_ptr<const void>          result;
+            uint64_t                             size_in_bytes;
+         };
+
+         void reset( const graphene::chain::block_id_type& head_block_id );
+         void store( const graphene::chain::block_id_type& head_block_id, const std::string& key,
+                     std::shared_ptr<const void> result, uint64_t size_in_bytes );
+
+         graphene::chain::database&                _db;
+         mutable std::mutex                        _mutex;
+         graphene::chain::block_id_type            _head_block_id;
+         std::unordered_map<std::string, entry>    _entries;
+         std::list<std::string>                    _insertion_order;
+         api_result_cache_stats                    _stats;
+         boost::signals2::scoped_connection        _applied_block_connection;
+   };
+
+} }
+
+FC_REFLECT( graphene::app::api_result_cache_stats,
+            (hits)(misses)(evictions)(entries)(size_in_bytes)(max_size_in_bytes) )
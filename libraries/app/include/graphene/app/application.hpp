@@ -24,9 +24,13 @@
 #pragma once
 
 #include <graphene/app/api_access.hpp>
+#include <graphene/app/api_request_scheduler.hpp>
+#include <graphene/app/api_result_cache.hpp>
 #include <graphene/net/node.hpp>
 #include <graphene/chain/database.hpp>
 
+#include <fc/thread/thread.hpp>
+
 #include <boost/program_options.hpp>
 
 namespace graphene { namespace app {
@@ -41,6 +45,12 @@ namespace graphene { namespace app {
          // TODO change default to false when GUI is ready
          bool enable_subscribe_to_all = true;
          bool has_market_history_plugin = false;
+         /// threads that serve expensive read-only database_api calls, empty unless api-read-threads is set
+         std::vector<std::shared_ptr<fc::thread>> api_read_threads;
+         /// results of database_api calls shared by all connections, null unless api-result-cache-size is set
+         std::shared_ptr<graphene::app::api_result_cache> api_result_cache;
+         /// admission control for websocket API requests, null unless api-max-cost-in-flight is set
+         std::shared_ptr<graphene::app::api_request_scheduler> api_request_scheduler;
    };
 
    class application
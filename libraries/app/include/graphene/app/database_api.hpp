@@ -23,12 +23,14 @@
  */
 #pragma once
 
+#include <graphene/app/api_result_cache.hpp>
 #include <graphene/app/full_account.hpp>
 
 #include <graphene/chain/protocol/types.hpp>
 
 #include <graphene/chain/database.hpp>
 
+#include <graphene/chain/access_footprint.hpp>
 #include <graphene/chain/access_layer.hpp>
 
 #include <graphene/chain/account_object.hpp>
@@ -191,6 +193,12 @@ struct tethered_accounts_balances_collection
    vector<tethered_accounts_balance> details;
 };
 
+struct block_access_batches
+{
+   vector<access_footprint>   footprints;
+   vector<vector<uint32_t>>   batches;
+};
+
 /**
  * @brief The database_api class implements the RPC API for the chain database.
  *
@@ -276,6 +284,14 @@ class database_api
        */
       processed_transaction get_transaction( uint32_t start_block_num, uint32_t trx_in_block )const;
 
+      /**
+       * @brief Show which of a block's transactions could be applied side by side
+       * @param block_num Height of the block
+       * @return the access footprint of each transaction and the transactions grouped into conflict-free batches,
+       * or null if no matching block was found
+       */
+      optional<block_access_batches> get_block_access_batches( uint32_t block_num )const;
+
       /**
        * If the transaction has not expired, this method will return the transaction for the given ID or
        * it will return NULL if it is not known.  Just because it is not known does not mean it wasn't
@@ -317,6 +333,16 @@ class database_api
        */
       optional<total_cycles_res> get_total_cycles() const;
 
+      /**
+       * @brief Get hit and size statistics of the shared result cache, if the node has it enabled
+       */
+      optional<api_result_cache_stats> get_api_result_cache_stats() const;
+
+      /**
+       * @brief Get queueing, rejection and timing statistics of API requests per method, if the node schedules them
+       */
+      optional<api_request_scheduler_stats> get_api_request_scheduler_stats() const;
+
       //////////
       // Keys //
       //////////
@@ -349,6 +375,28 @@ class database_api
        */
       std::map<string,full_account> get_full_accounts( const vector<string>& names_or_ids, bool subscribe );
 
+      /**
+       * @brief Fetch only some of the objects related to each of the given accounts
+       * @param names_or_ids Each item must be the name or ID of an account to retrieve
+       * @param fields Parts of @ref full_account to fill in besides the account itself, any of "statistics",
+       *        "referrer_names", "cashback_balance", "balances", "vesting_balances", "limit_orders", "call_orders"
+       *        and "proposals". All of them are filled in if empty.
+       * @return Map of string from @ref names_or_ids to the corresponding account
+       *
+       * Like @ref get_full_accounts, but does not subscribe to the accounts and skips the parts not asked for.
+       */
+      std::map<string,full_account> get_full_accounts_with_fields( const vector<string>& names_or_ids,
+                                                                   const vector<string>& fields )const;
+
+      /**
+       * @brief Page through all accounts with the chosen parts of their related objects
+       * @param start ID of the first account to return
+       * @param limit Maximum number of accounts to return -- must not exceed 100
+       * @param fields Parts of @ref full_account to fill in, as in @ref get_full_accounts_with_fields
+       * @return Up to @ref limit accounts in ID order, and the ID to start the next page from if there is one
+       */
+      full_accounts_page get_full_accounts_page( account_id_type start, uint32_t limit, const vector<string>& fields )const;
+
       optional<account_object> get_account_by_name( string name )const;
 
       /**
@@ -879,6 +927,14 @@ class database_api
        */
       vector<acc_id_queue_subs_w_pos_res> get_queue_submissions_with_pos_for_accounts(vector<account_id_type> ids) const;
 
+      /**
+       * @brief Page through the reward queue submissions of all accounts that have any
+       * @param start ID of the first account to consider
+       * @param limit Maximum number of accounts to return -- must not exceed 100
+       * @return Submissions of up to @ref limit accounts in ID order, and the ID to start the next page from if there is one
+       */
+      queue_submissions_with_pos_page get_queue_submissions_with_pos_page(account_id_type start, uint32_t limit) const;
+
       //////////////////////////
       // REQUESTS:            //
       //////////////////////////
@@ -915,6 +971,14 @@ class database_api
        */
       vector<acc_id_vault_info_res> get_vaults_info(vector<account_id_type> vault_ids) const;
 
+      /**
+       * @brief Page through the information of all vaults.
+       * @param start ID of the first account to consider
+       * @param limit Maximum number of vaults to return -- must not exceed 1000
+       * @return Up to @ref limit vaults in ID order, and the ID to start the next page from if there is one
+       */
+      vaults_info_page get_vaults_info_page(account_id_type start, uint32_t limit) const;
+
       /**
        * @brief Calculates and returns the amount of asset one needs to pay to get the given amount of cycles
        * @param cycle_amount Desired amount of cycles to get
@@ -1047,6 +1111,7 @@ FC_REFLECT( graphene::app::dasc_holder, (holder)(vaults)(amount) );
 FC_REFLECT( graphene::app::daspay_authority, (payment_provider)(daspay_public_key)(memo) );
 FC_REFLECT( graphene::app::tethered_accounts_balance, (account)(name)(kind)(balance)(reserved) );
 FC_REFLECT( graphene::app::tethered_accounts_balances_collection, (asset_id)(total)(details) );
+FC_REFLECT( graphene::app::block_access_batches, (footprints)(batches) );
 
 FC_API( graphene::app::database_api,
    // Objects
@@ -1064,6 +1129,7 @@ FC_API( graphene::app::database_api,
    (get_blocks)
    (get_blocks_with_virtual_operations)
    (get_transaction)
+   (get_block_access_batches)
    (get_recent_transaction_by_id)
 
    // Globals
@@ -1073,6 +1139,8 @@ FC_API( graphene::app::database_api,
    (get_chain_id)
    (get_dynamic_global_properties)
    (get_total_cycles)
+   (get_api_result_cache_stats)
+   (get_api_request_scheduler_stats)
 
    // Keys
    (get_key_references)
@@ -1080,6 +1148,8 @@ FC_API( graphene::app::database_api,
    // Accounts
    (get_accounts)
    (get_full_accounts)
+   (get_full_accounts_with_fields)
+   (get_full_accounts_page)
    (get_account_by_name)
    (get_account_references)
    (lookup_account_names)
@@ -1174,6 +1244,7 @@ FC_API( graphene::app::database_api,
    (get_reward_queue_by_page)
    (get_queue_submissions_with_pos)
    (get_queue_submissions_with_pos_for_accounts)
+   (get_queue_submissions_with_pos_page)
 
    // Requests
    (get_all_webasset_issue_requests)
@@ -1183,6 +1254,7 @@ FC_API( graphene::app::database_api,
    // Vaults
    (get_vault_info)
    (get_vaults_info)
+   (get_vaults_info_page)
 
    // Calculate cycle price
    (calculate_cycle_price)
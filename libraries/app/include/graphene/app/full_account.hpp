@@ -46,6 +46,16 @@ namespace graphene { namespace app {
       vector<proposal_object>          proposals;
    };
 
+   /**
+    * One page of full accounts in account id order. Pass next as the start of the following query to get the next
+    * page; next is not set on the last page.
+    */
+   struct full_accounts_page
+   {
+      vector<full_account>             accounts;
+      optional<account_id_type>        next;
+   };
+
 } }
 
 FC_REFLECT( graphene::app::full_account, 
@@ -62,3 +72,5 @@ FC_REFLECT( graphene::app::full_account,
             (call_orders)
             (proposals) 
           )
+
+FC_REFLECT( graphene::app::full_accounts_page, (accounts)(next) )
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <graphene/chain/access_footprint.hpp>
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/queue_objects.hpp>
+
+#include <map>
+
+namespace graphene { namespace chain {
+
+namespace {
+
+/**
+ * Operations are unbounded unless declared here. Declare an operation only when its evaluator provably writes
+ * nothing but the listed state; when in doubt leave it unbounded.
+ */
+struct get_access_footprint_visitor
+{
+   access_footprint& _footprint;
+   get_access_footprint_visitor( access_footprint& footprint ):_footprint(footprint) {}
+   typedef void result_type;
+
+   template<typename Operation>
+   void operator()( const Operation& op )
+   {
+      _footprint.unbounded = true;
+   }
+
+   void operator()( const transfer_operation& op )
+   {
+      add_fee( op.fee_payer(), op.fee );
+      _footprint.accounts.insert( op.from );
+      _footprint.accounts.insert( op.to );
+      // The receiver may not hold the asset yet
+      add_create<account_balance_object>();
+   }
+
+   void operator()( const transfer_vault_to_wallet_operation& op )
+   {
+      add_fee( op.fee_payer(), op.fee );
+      _footprint.accounts.insert( op.from_vault );
+      _footprint.accounts.insert( op.to_wallet );
+   }
+
+   void operator()( const transfer_wallet_to_vault_operation& op )
+   {
+      add_fee( op.fee_payer(), op.fee );
+      _footprint.accounts.insert( op.from_wallet );
+      _footprint.accounts.insert( op.to_vault );
+   }
+
+   void operator()( const submit_cycles_to_queue_operation& op )
+   {
+      add_fee( op.fee_payer(), op.fee );
+      _footprint.accounts.insert( op.account );
+      // The submission number and the queue order come from the dynamic global properties
+      _footprint.objects.insert( dynamic_global_property_id_type() );
+      add_create<reward_queue_object>();
+   }
+
+   void operator()( const daspay_debit_account_operation& op )
+   {
+      add_fee( op.fee_payer(), op.fee );
+      _footprint.accounts.insert( op.account );
+      _footprint.accounts.insert( op.clearing_account );
+      // The debit ratio, and the payment service providers only undeclared operations write
+      _footprint.reads.insert( dynamic_global_property_id_type() );
+      add_create<account_balance_object>();
+   }
+
+   void operator()( const daspay_credit_account_operation& op )
+   {
+      add_fee( op.fee_payer(), op.fee );
+      _footprint.accounts.insert( op.account );
+      _footprint.accounts.insert( op.clearing_account );
+      // The credit ratio
+      _footprint.reads.insert( dynamic_global_property_id_type() );
+      add_create<account_balance_object>();
+   }
+
+   void operator()( const set_roll_back_enabled_operation& op )
+   {
+      add_fee( op.fee_payer(), op.fee );
+      _footprint.accounts.insert( op.account );
+   }
+
+private:
+   template<typename Object>
+   void add_create()
+   {
+      _footprint.creates.emplace( Object::space_id, Object::type_id );
+   }
+
+   /// Mirrors generic_evaluator::prepare_fee(), where a fee in the core asset is not charged
+   void add_fee( account_id_type payer, const asset& fee )
+   {
+      _footprint.accounts.insert( payer );
+      if( fee.amount > 0 && fee.asset_id != asset_id_type() )
+         _footprint.pays_fee = true;
+   }
+};
+
+} // anonymous namespace
+
+void access_footprint::merge( const access_footprint& other )
+{
+   accounts.insert( other.accounts.begin(), other.accounts.end() );
+   objects.insert( other.objects.begin(), other.objects.end() );
+   reads.insert( other.reads.begin(), other.reads.end() );
+   creates.insert( other.creates.begin(), other.creates.end() );
+   pays_fee = pays_fee || other.pays_fee;
+   unbounded = unbounded || other.unbounded;
+}
+
+void operation_get_access_footprint( const operation& op, access_footprint& result )
+{
+   get_access_footprint_visitor vtor( result );
+   op.visit( vtor );
+}
+
+void transaction_get_access_footprint( const transaction& tx, access_footprint& result )
+{
+   for( const auto& op : tx.operations )
+      operation_get_access_footprint( op, result );
+}
+
+vector<vector<uint32_t>> build_conflict_free_batches( const vector<access_footprint>& footprints,
+                                                      account_id_type fee_pool_account )
+{
+   vector<vector<uint32_t>> batches;
+   // Each footprint goes into the batch right after the last one it conflicts with
+   std::map<object_id_type, uint32_t> last_write;
+   std::map<object_id_type, uint32_t> last_read;
+   optional<uint32_t> last_fee;  // only tracked while fees are burnt
+   optional<uint32_t> last_fee_payer;  // only tracked while fees are credited to the fee pool account
+   const bool burns_fees = ( fee_pool_account == account_id_type() );
+   uint32_t barrier = 0; // first batch after the last unbounded footprint
+
+   for( uint32_t i = 0; i < footprints.size(); ++i )
+   {
+      const auto& footprint = footprints[i];
+      vector<object_id_type> keys( footprint.accounts.begin(), footprint.accounts.end() );
+      keys.insert( keys.end(), footprint.objects.begin(), footprint.objects.end() );
+      const bool writes_fee_pool = !burns_fees && footprint.accounts.count( fee_pool_account );
+
+      uint32_t batch = barrier;
+      if( footprint.unbounded )
+         batch = batches.size();
+      else
+      {
+         for( const auto& key : keys )
+         {
+            auto itr = last_write.find( key );
+            if( itr != last_write.end() )
+               batch = std::max( batch, itr->second + 1 );
+            // A write must not overtake an earlier read either
+            itr = last_read.find( key );
+            if( itr != last_read.end() )
+               batch = std::max( batch, itr->second + 1 );
+         }
+         for( const auto& key : footprint.reads )
+         {
+            auto itr = last_write.find( key );
+            if( itr != last_write.end() )
+               batch = std::max( batch, itr->second + 1 );
+         }
+         if( footprint.pays_fee && burns_fees && last_fee.valid() )
+            batch = std::max( batch, *last_fee + 1 );
+         // Seeing the fee pool account's balances requires all fees paid before to be credited
+         if( writes_fee_pool && last_fee_payer.valid() )
+            batch = std::max( batch, *last_fee_payer + 1 );
+         if( footprint.pays_fee && !burns_fees )
+         {
+            auto itr = last_write.find( fee_pool_account );
+            if( itr != last_write.end() )
+               batch = std::max( batch, itr->second + 1 );
+         }
+      }
+
+      if( batch == batches.size() )
+         batches.emplace_back();
+      batches[batch].push_back( i );
+
+      if( footprint.unbounded )
+         barrier = batch + 1;
+      for( const auto& key : keys )
+         last_write[key] = batch;
+      for( const auto& key : footprint.reads )
+         last_read[key] = std::max( batch, last_read.count( key ) ? last_read[key] : 0 );
+      if( footprint.pays_fee )
+      {
+         if( burns_fees )
+            last_fee = batch;
+         else
+            last_fee_payer = std::max( batch, last_fee_payer.valid() ? *last_fee_payer : 0 );
+      }
+   }
+
+   return batches;
+}
+
+} } // graphene::chain
@@ -272,6 +272,47 @@ vector<acc_id_queue_subs_w_pos_res>
                                                                    this, std::placeholders::_1));
 }
 
+queue_submissions_with_pos_page
+    database_access_layer::get_queue_submissions_with_pos_page(account_id_type start, uint32_t limit) const
+{
+    FC_ASSERT(limit <= 100, "Cannot retrieve more than ${max} accounts in one page", ("max", 100));
+
+    queue_submissions_with_pos_page page;
+
+    const auto& queue_multi_idx = _db.get_index_type<reward_queue_index>().indices();
+    const auto& account_idx = queue_multi_idx.get<by_account>();
+    const auto& time_idx = queue_multi_idx.get<by_time>();
+
+    // Group the submissions of the first limit accounts at or after start:
+    auto it = account_idx.lower_bound(boost::make_tuple(start));
+    std::map<object_id_type, std::pair<size_t, size_t>> page_submissions;  // submission -> (account, submission) slot
+    while (it != account_idx.end()) {
+        if (page.accounts.empty() || page.accounts.back().account_id != it->account) {
+            if (page.accounts.size() == limit) {
+                page.next = it->account;
+                break;
+            }
+            page.accounts.emplace_back(it->account, vector<sub_w_pos>{});
+        }
+        auto& submissions = *page.accounts.back().result;
+        page_submissions.emplace(it->id, std::make_pair(page.accounts.size() - 1, submissions.size()));
+        submissions.emplace_back(0, *it);
+        ++it;
+    }
+
+    // Find all positions with a single pass over the queue rather than one per submission:
+    uint32_t pos = 0;
+    for (auto time_it = time_idx.begin(); time_it != time_idx.end() && !page_submissions.empty(); ++time_it, ++pos) {
+        auto slot = page_submissions.find(time_it->id);
+        if (slot != page_submissions.end()) {
+            (*page.accounts[slot->second.first].result)[slot->second.second].position = pos;
+            page_submissions.erase(slot);
+        }
+    }
+
+    return page;
+}
+
 optional<vault_info_res> database_access_layer::get_vault_info(account_id_type vault_id) const
 {
     const auto& account = get_opt<account_id_type, account_index, by_id>(vault_id);
@@ -306,6 +347,27 @@ vector<acc_id_vault_info_res> database_access_layer::get_vaults_info(vector<acco
     });
 }
 
+vaults_info_page database_access_layer::get_vaults_info_page(account_id_type start, uint32_t limit) const
+{
+    FC_ASSERT(limit <= 1000, "Cannot retrieve more than ${max} vaults in one page", ("max", 1000));
+
+    vaults_info_page page;
+    page.vaults.reserve(limit);
+
+    const auto& idx = _db.get_index_type<account_index>().indices().get<by_id>();
+    for (auto it = idx.lower_bound(start); it != idx.end(); ++it) {
+        if (!it->is_vault())
+            continue;
+        if (page.vaults.size() == limit) {
+            page.next = it->get_id();
+            break;
+        }
+        page.vaults.emplace_back(it->get_id(), get_vault_info(it->get_id()));
+    }
+
+    return page;
+}
+
 optional<asset_object> database_access_layer::lookup_asset_symbol(const string& symbol_or_id) const
 {
     return get_asset_symbol(_db.get_index_type<asset_index>(), symbol_or_id);
@@ -0,0 +1,85 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <graphene/chain/authority_verification_cache.hpp>
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/database.hpp>
+
+namespace graphene { namespace chain {
+
+void authority_verification_cache::verify( const vector<operation>& ops, const flat_set<public_key_type>& sigs,
+                                           const database& db, uint32_t max_recursion )
+{
+   flat_set<account_id_type> required_active;
+   flat_set<account_id_type> required_owner;
+   vector<authority> other;
+   for( const auto& op : ops )
+      operation_get_required_authorities( op, required_active, required_owner, other );
+
+   auto get_active = [&db]( account_id_type id ) { return &id(db).active; };
+   auto get_owner  = [&db]( account_id_type id ) { return &id(db).owner;  };
+
+   // Operations requiring other authorities are rare, don't bother remembering those
+   if( !other.empty() )
+   {
+      verify_authority( ops, sigs, get_active, get_owner, max_recursion );
+      return;
+   }
+
+   key_type key( sigs, std::move(required_active), std::move(required_owner), max_recursion );
+   auto itr = _entries.find( key );
+   if( itr != _entries.end() && unchanged( itr->second, db ) )
+      return;
+
+   vector<consulted_authority> consulted;
+   auto consult = [&]( account_id_type id, bool owner ) -> const authority* {
+      const account_object& account = id(db);
+      const authority& auth = owner ? account.owner : account.active;
+      consulted.push_back( { id, owner, owner ? account.owner_change_counter : account.active_change_counter, auth } );
+      return &auth;
+   };
+   verify_authority( ops, sigs,
+                     [&]( account_id_type id ) { return consult( id, false ); },
+                     [&]( account_id_type id ) { return consult( id, true ); },
+                     max_recursion );
+
+   if( _entries.size() >= max_entries )
+      _entries.clear();
+   _entries[std::move(key)] = std::move(consulted);
+}
+
+bool authority_verification_cache::unchanged( const vector<consulted_authority>& consulted, const database& db )
+{
+   for( const auto& c : consulted )
+   {
+      const account_object* account = db.find( c.account );
+      if( account == nullptr )
+         return false;
+      const uint32_t version = c.owner ? account->owner_change_counter : account->active_change_counter;
+      if( version != c.version || !( (c.owner ? account->owner : account->active) == c.auth ) )
+         return false;
+   }
+   return true;
+}
+
+} } // graphene::chain
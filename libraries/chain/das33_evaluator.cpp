@@ -32,14 +32,8 @@ namespace graphene { namespace chain {
   // Helper methods:
   share_type users_total_pledges_in_round(account_id_type user_id, das33_project_id_type project_id, share_type round, const database& d)
   {
-    share_type sum = 0;
-    const auto& idx = d.get_index_type<das33_pledge_holder_index>().indices().get<by_user>().equal_range(user_id);
-    for( auto it = idx.first; it != idx.second; ++it )
-    {
-      if (it->project_id == project_id && it->phase_number == round)
-        sum += (it->base_expected.amount);
-    }
-    return sum;
+    const auto& idx = dynamic_cast<const primary_index<das33_pledge_holder_index>&>(d.get_index_type<das33_pledge_holder_index>());
+    return idx.get_secondary_index<das33_pledge_totals_index>().get_user_round_total(user_id, project_id, round);
   }
 
   void price_check(const price& price_to_check, asset_id_type first_asset, asset_id_type second_asset)
@@ -530,18 +524,26 @@ namespace graphene { namespace chain {
 
     auto& d = db();
 
-    std::vector<object_id_type> pledges_to_remove;
-    const auto& index = d.get_index_type<das33_pledge_holder_index>().indices().get<by_project>().equal_range(op.project);
-    auto itr = index.first;
-
-    while(itr != index.second)
+    // Pledges to distribute, in id order. With a phase given this is a range scan of that phase only:
+    std::vector<const das33_pledge_holder_object*> pledges;
+    if( op.phase_number.valid() )
     {
-       if(op.phase_number.valid() && itr->phase_number != *op.phase_number) {
-           ++itr;
-           continue;
-       }
+       const auto& index = d.get_index_type<das33_pledge_holder_index>().indices().get<by_project_phase>();
+       auto range = index.equal_range(boost::make_tuple(op.project, *op.phase_number));
+       for( auto itr = range.first; itr != range.second; ++itr )
+          pledges.push_back(&*itr);
+    }
+    else
+    {
+       const auto& index = d.get_index_type<das33_pledge_holder_index>().indices().get<by_project>();
+       auto range = index.equal_range(op.project);
+       for( auto itr = range.first; itr != range.second; ++itr )
+          pledges.push_back(&*itr);
+    }
 
-       const das33_pledge_holder_object& pho = *itr;
+    for( const das33_pledge_holder_object* pledge_ptr : pledges )
+    {
+       const das33_pledge_holder_object& pho = *pledge_ptr;
 
        // calc amount of token and asset that will be exchanged
        share_type base = std::round(static_cast<double>(pho.base_expected.amount.value) * op.base_to_pledger.value / BONUS_PRECISION / 100);
@@ -588,18 +590,7 @@ namespace graphene { namespace chain {
 
        // if everything is distributed remove object
        if(pho.pledge_remaining.amount + pho.base_remaining.amount + pho.bonus_remaining.amount <= 0)
-       {
-          pledges_to_remove.push_back(pho.id);
-       }
-       itr++;
-    }
-
-    auto& index1 = d.get_index_type<das33_pledge_holder_index>().indices().get<by_id>();
-    for(object_id_type id : pledges_to_remove)
-    {
-       auto itr = index1.find(id);
-       if(itr != index1.end())
-          d.remove(*itr);
+          d.remove(pho);
     }
 
     return {};
@@ -0,0 +1,88 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <graphene/chain/das33_object.hpp>
+
+namespace graphene { namespace chain {
+
+  void das33_pledge_totals_index::object_inserted( const object& obj )
+  {
+    apply( static_cast<const das33_pledge_holder_object&>(obj), true );
+  }
+
+  void das33_pledge_totals_index::object_removed( const object& obj )
+  {
+    apply( static_cast<const das33_pledge_holder_object&>(obj), false );
+  }
+
+  void das33_pledge_totals_index::about_to_modify( const object& before )
+  {
+    apply( static_cast<const das33_pledge_holder_object&>(before), false );
+  }
+
+  void das33_pledge_totals_index::object_modified( const object& after )
+  {
+    apply( static_cast<const das33_pledge_holder_object&>(after), true );
+  }
+
+  void das33_pledge_totals_index::apply( const das33_pledge_holder_object& pledge, bool add )
+  {
+    // The null pledge created at genesis is not a pledge:
+    if( pledge.id == das33_pledge_holder_id_type() )
+      return;
+
+    const auto user_key = std::make_tuple( pledge.account_id, pledge.project_id, pledge.phase_number );
+    auto& user_total = _user_round_totals[user_key];
+    user_total += add ? pledge.base_expected.amount : -pledge.base_expected.amount;
+    if( user_total == 0 )
+      _user_round_totals.erase( user_key );
+
+    auto& project_totals = _project_totals[pledge.project_id];
+    auto& asset_total = project_totals[pledge.pledged.asset_id];
+    asset_total += add ? pledge.pledged.amount : -pledge.pledged.amount;
+    if( asset_total == 0 )
+      project_totals.erase( pledge.pledged.asset_id );
+    if( project_totals.empty() )
+      _project_totals.erase( pledge.project_id );
+  }
+
+  share_type das33_pledge_totals_index::get_user_round_total( account_id_type account, das33_project_id_type project,
+                                                              share_type phase_number ) const
+  {
+    auto itr = _user_round_totals.find( std::make_tuple( account, project, phase_number ) );
+    return itr != _user_round_totals.end() ? itr->second : share_type(0);
+  }
+
+  vector<asset> das33_pledge_totals_index::get_project_totals( das33_project_id_type project ) const
+  {
+    vector<asset> result;
+    auto itr = _project_totals.find( project );
+    if( itr != _project_totals.end() )
+      for( const auto& asset_total : itr->second )
+        result.emplace_back( asset_total.second, asset_total.first );
+    return result;
+  }
+
+} }  // namespace graphene::chain
@@ -291,6 +291,44 @@ void database::adjust_cycle_balance(account_id_type account, share_type delta)
 
 } FC_CAPTURE_AND_RETHROW( (account)(delta) ) }
 
+void database::credit_fee_pool(const asset& fee)
+{
+   const auto& dynamic_properties = get_dynamic_global_properties();
+   if( dynamic_properties.fee_pool_account_id != account_id_type() )
+   {
+      if( _defer_fee_pool_credits )
+      {
+         _fee_pool_credits[fee.asset_id] += fee.amount;
+         return;
+      }
+      modify(get_balance_object(dynamic_properties.fee_pool_account_id, fee.asset_id), [&](account_balance_object& b)
+      {
+         b.balance += fee.amount;
+      });
+   }
+   else // this means that we have to burn fee asset
+   {
+      modify(fee.asset_id(*this).dynamic_asset_data_id(*this), [&](asset_dynamic_data_object& addo)
+      {
+         addo.current_supply -= fee.amount;
+      });
+   }
+}
+
+void database::flush_fee_pool_credits()
+{
+   if( _fee_pool_credits.empty() )
+      return;
+
+   const auto fee_pool_account_id = get_dynamic_global_properties().fee_pool_account_id;
+   for( const auto& credit : _fee_pool_credits )
+      modify(get_balance_object(fee_pool_account_id, credit.first), [&](account_balance_object& b)
+      {
+         b.balance += credit.second;
+      });
+   _fee_pool_credits.clear();
+}
+
 optional<uint8_t> database::get_account_pi_level(const account_id_type account) const
 { try {
    auto& index = get_index_type<account_index>().indices().get<by_id>();
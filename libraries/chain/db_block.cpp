@@ -24,6 +24,7 @@
 
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/db_with.hpp>
+#include <graphene/chain/access_footprint.hpp>
 #include <graphene/chain/hardfork.hpp>
 
 #include <graphene/chain/block_summary_object.hpp>
@@ -37,6 +38,7 @@
 #include <graphene/chain/evaluator.hpp>
 
 #include <fc/smart_ref_impl.hpp>
+#include <fc/thread/thread.hpp>
 
 namespace graphene { namespace chain {
 
@@ -143,9 +145,36 @@ std::vector<block_id_type> database::get_block_ids_on_fork(block_id_type head_of
  *
  * @return true if we switched forks as a result of this push.
  */
+/**
+ * Holds the state lock exclusively for its lifetime when concurrent reads are
+ * enabled.  The modifying calls nest (push_block pops blocks when switching
+ * forks), so only the outermost one locks.
+ */
+struct database::state_write_lock
+{
+   explicit state_write_lock( database& db ) : _db( db )
+   {
+      if( !_db._concurrent_reads_enabled )
+         return;
+      _counted = true;
+      if( _db._state_write_depth++ == 0 )
+         _db._state_mutex.lock();
+   }
+
+   ~state_write_lock()
+   {
+      if( _counted && --_db._state_write_depth == 0 )
+         _db._state_mutex.unlock();
+   }
+
+   database& _db;
+   bool      _counted = false;
+};
+
 bool database::push_block(const signed_block& new_block, uint32_t skip)
 {
    //idump((new_block.block_num())(new_block.id())(new_block.timestamp)(new_block.previous));
+   state_write_lock write_lock( *this );
    bool result;
    detail::with_skip_flags( *this, skip, [&]()
    {
@@ -259,6 +288,7 @@ bool database::_push_block(const signed_block& new_block)
  */
 processed_transaction database::push_transaction( const signed_transaction& trx, uint32_t skip )
 { try {
+   state_write_lock write_lock( *this );
    processed_transaction result;
    detail::with_skip_flags( *this, skip, [&]()
    {
@@ -283,6 +313,9 @@ processed_transaction database::_push_transaction( const signed_transaction& trx
    auto processed_trx = _apply_transaction( trx );
    _pending_tx.push_back(processed_trx);
 
+   if( _speculative_block.valid() )
+      append_to_speculative_block( processed_trx );
+
    // notify_changed_objects();
    // The transaction applied successfully. Merge its changes into the pending block session.
    temp_session.merge();
@@ -325,6 +358,7 @@ processed_transaction database::push_proposal(const proposal_object& proposal)
       }
       else
       {
+         materialize_applied_operations();
          _applied_ops.resize( old_applied_ops_size );
       }
       wlog( "${e}", ("e",e.to_detail_string() ) );
@@ -342,6 +376,7 @@ signed_block database::generate_block(
    uint32_t skip /* = 0 */
    )
 { try {
+   state_write_lock write_lock( *this );
    signed_block result;
    detail::with_skip_flags( *this, skip, [&]()
    {
@@ -350,6 +385,40 @@ signed_block database::generate_block(
    return result;
 } FC_CAPTURE_AND_RETHROW() }
 
+void database::assemble_speculative_block( fc::time_point_sec when, witness_id_type witness_id )
+{ try {
+   state_write_lock write_lock( *this );
+   uint32_t slot_num = get_slot_at_time( when );
+   FC_ASSERT( slot_num > 0 );
+   FC_ASSERT( get_scheduled_witness( slot_num ) == witness_id );
+
+   static const size_t max_block_header_size = fc::raw::pack_size( signed_block_header() ) + 4;
+
+   _speculative_block = signed_block();
+   _speculative_block->previous = head_block_id();
+   _speculative_block->timestamp = when;
+   _speculative_block->witness = witness_id;
+   _speculative_block_size = max_block_header_size;
+
+   // _pending_tx_session already holds the result of applying _pending_tx on top of the head block, and
+   // transactions are evaluated against head_block_time() both here and when the block is applied, so the
+   // pending transactions can be taken over as they are.
+   for( const processed_transaction& tx : _pending_tx )
+      append_to_speculative_block( tx );
+} FC_CAPTURE_AND_RETHROW( (when)(witness_id) ) }
+
+void database::append_to_speculative_block( const processed_transaction& trx )
+{
+   size_t new_total_size = _speculative_block_size + fc::raw::pack_size( trx );
+
+   // postpone transaction if it would make block too big
+   if( new_total_size >= get_global_properties().parameters.maximum_block_size )
+      return;
+
+   _speculative_block_size = new_total_size;
+   _speculative_block->transactions.push_back( trx );
+}
+
 signed_block database::_generate_block(
    fc::time_point_sec when,
    witness_id_type witness_id,
@@ -374,56 +443,68 @@ signed_block database::_generate_block(
 
    signed_block pending_block;
 
-   //
-   // The following code throws away existing pending_tx_session and
-   // rebuilds it by re-applying pending transactions.
-   //
-   // This rebuild is necessary because pending transactions' validity
-   // and semantics may have changed since they were received, because
-   // time-based semantics are evaluated based on the current block
-   // time.  These changes can only be reflected in the database when
-   // the value of the "when" variable is known, which means we need to
-   // re-apply pending transactions in this method.
-   //
-   _pending_tx_session.reset();
-   _pending_tx_session = _undo_db.start_undo_session();
-
-   uint64_t postponed_tx_count = 0;
-   // pop pending state (reset to head block state)
-   for( const processed_transaction& tx : _pending_tx )
+   if( _speculative_block.valid() && _speculative_block->previous == head_block_id() &&
+       _speculative_block->timestamp == when && _speculative_block->witness == witness_id )
+   {
+      // The candidate was assembled ahead of the slot from the already applied pending state,
+      // so there is no need to re-apply the pending transactions here.
+      pending_block = std::move( *_speculative_block );
+      _speculative_block.reset();
+   }
+   else
    {
-      size_t new_total_size = total_block_size + fc::raw::pack_size( tx );
+      //
+      // The following code throws away existing pending_tx_session and
+      // rebuilds it by re-applying pending transactions.
+      //
+      // This rebuild is necessary because pending transactions' validity
+      // and semantics may have changed since they were received, because
+      // time-based semantics are evaluated based on the current block
+      // time.  These changes can only be reflected in the database when
+      // the value of the "when" variable is known, which means we need to
+      // re-apply pending transactions in this method.
+      //
+      _speculative_block.reset();
+      _pending_tx_session.reset();
+      _pending_tx_session = _undo_db.start_undo_session();
 
-      // postpone transaction if it would make block too big
-      if( new_total_size >= maximum_block_size )
+      uint64_t postponed_tx_count = 0;
+      // pop pending state (reset to head block state)
+      for( const processed_transaction& tx : _pending_tx )
       {
-         postponed_tx_count++;
-         continue;
-      }
+         size_t new_total_size = total_block_size + fc::raw::pack_size( tx );
 
-      try
-      {
-         auto temp_session = _undo_db.start_undo_session();
-         processed_transaction ptx = _apply_transaction( tx );
-         temp_session.merge();
-
-         // We have to recompute pack_size(ptx) because it may be different
-         // than pack_size(tx) (i.e. if one or more results increased
-         // their size)
-         total_block_size += fc::raw::pack_size( ptx );
-         pending_block.transactions.push_back( ptx );
+         // postpone transaction if it would make block too big
+         if( new_total_size >= maximum_block_size )
+         {
+            postponed_tx_count++;
+            continue;
+         }
+
+         try
+         {
+            auto temp_session = _undo_db.start_undo_session();
+            processed_transaction ptx = _apply_transaction( tx );
+            temp_session.merge();
+
+            // We have to recompute pack_size(ptx) because it may be different
+            // than pack_size(tx) (i.e. if one or more results increased
+            // their size)
+            total_block_size += fc::raw::pack_size( ptx );
+            pending_block.transactions.push_back( ptx );
+         }
+         catch ( const fc::exception& e )
+         {
+            // Do nothing, transaction will not be re-applied
+            wlog( "Transaction was not processed while generating block due to ${e}", ("e", e) );
+            wlog( "The transaction was ${t}", ("t", tx) );
+         }
       }
-      catch ( const fc::exception& e )
+      if( postponed_tx_count > 0 )
       {
-         // Do nothing, transaction will not be re-applied
-         wlog( "Transaction was not processed while generating block due to ${e}", ("e", e) );
-         wlog( "The transaction was ${t}", ("t", tx) );
+         wlog( "Postponed ${n} transactions due to block size limit", ("n", postponed_tx_count) );
       }
    }
-   if( postponed_tx_count > 0 )
-   {
-      wlog( "Postponed ${n} transactions due to block size limit", ("n", postponed_tx_count) );
-   }
 
    _pending_tx_session.reset();
 
@@ -458,7 +539,9 @@ signed_block database::_generate_block(
  */
 void database::pop_block()
 { try {
+   state_write_lock write_lock( *this );
    _pending_tx_session.reset();
+   _speculative_block.reset();
    auto head_id = head_block_id();
    optional<signed_block> head_block = fetch_block_by_id( head_id );
    GRAPHENE_ASSERT( head_block.valid(), pop_empty_chain, "there are no blocks to pop" );
@@ -472,14 +555,28 @@ void database::pop_block()
 
 void database::clear_pending()
 { try {
+   state_write_lock write_lock( *this );
    assert( (_pending_tx.size() == 0) || _pending_tx_session.valid() );
    _pending_tx.clear();
    _pending_tx_session.reset();
+   _speculative_block.reset();
 } FC_CAPTURE_AND_RETHROW() }
 
 uint32_t database::push_applied_operation( const operation& op )
 {
    _applied_ops.emplace_back(op);
+   return init_applied_operation();
+}
+
+uint32_t database::push_applied_operation_reference( const operation& op )
+{
+   _applied_ops.emplace_back(operation_history_object());
+   _unmaterialized_applied_ops.emplace_back( _applied_ops.size() - 1, &op );
+   return init_applied_operation();
+}
+
+uint32_t database::init_applied_operation()
+{
    operation_history_object& oh = *(_applied_ops.back());
    oh.block_num    = _current_block_num;
    oh.trx_in_block = _current_trx_in_block;
@@ -500,9 +597,20 @@ void database::set_applied_operation_result( uint32_t op_id, const operation_res
 
 const vector<optional< operation_history_object > >& database::get_applied_operations() const
 {
+   materialize_applied_operations();
    return _applied_ops;
 }
 
+void database::materialize_applied_operations() const
+{
+   for( const auto& item : _unmaterialized_applied_ops )
+   {
+      if( item.first < _applied_ops.size() && _applied_ops[item.first].valid() )
+         _applied_ops[item.first]->op = *item.second;
+   }
+   _unmaterialized_applied_ops.clear();
+}
+
 //////////////////// private methods ////////////////////
 
 void database::apply_block( const signed_block& next_block, uint32_t skip )
@@ -527,6 +635,7 @@ void database::apply_block( const signed_block& next_block, uint32_t skip )
 
 void database::applied_ops_to_virtual_ops( )
 {
+   materialize_applied_operations();
    for(auto& ooho : _applied_ops)
    {
       if(ooho.valid())
@@ -559,9 +668,27 @@ void database::_apply_block( const signed_block& next_block )
 { try {
    uint32_t next_block_num = next_block.block_num();
    uint32_t skip = get_node_properties().skip_flags;
+   auto& profiler = _execution_profiler;
+   const auto block_started = profiler.start();
    applied_ops_to_virtual_ops();
    _applied_ops.clear();
 
+   // The operations of next_block's transactions are recorded by reference and only copied into their
+   // operation_history_object if get_applied_operations() is called before they are cleared below
+   struct applied_operations_by_reference
+   {
+      database& _db;
+      explicit applied_operations_by_reference( database& db ) : _db( db )
+      {
+         _db._applied_ops_by_reference = true;
+      }
+      ~applied_operations_by_reference()
+      {
+         _db._applied_ops_by_reference = false;
+         _db.materialize_applied_operations();
+      }
+   } by_reference( *this );
+
    FC_ASSERT( (skip & skip_merkle_check) || next_block.transaction_merkle_root == next_block.calculate_merkle_root(), "", ("next_block.transaction_merkle_root",next_block.transaction_merkle_root)("calc",next_block.calculate_merkle_root())("next_block",next_block)("id",next_block.id()) );
 
    const witness_object& signing_witness = validate_block_header(skip, next_block);
@@ -572,32 +699,66 @@ void database::_apply_block( const signed_block& next_block )
    _current_block_num    = next_block_num;
    _current_trx_in_block = 0;
 
-   for( const auto& trx : next_block.transactions )
+   // only used if precompute_transactions() ran for this very block, never waited for here
+   vector<optional<transaction_id_type>> validated_ids;
+   if( _precomputed_block_id == next_block.id() && _precomputed_trx_ids.size() == next_block.transactions.size() )
+      validated_ids = std::move( _precomputed_trx_ids );
+   else
+      validated_ids.resize( next_block.transactions.size() );
+   _precomputed_trx_ids.clear();
+   _precomputed_block_id = block_id_type();
+   const auto transactions_started = profiler.start();
    {
-      /* We do not need to push the undo state for each transaction
-       * because they either all apply and are valid or the
-       * entire block fails to apply.  We only need an "undo" state
-       * for transactions when validating broadcast transactions or
-       * when building a block.
-       */
-      apply_transaction( trx, skip | skip_transaction_signatures );
-      ++_current_trx_in_block;
+      // Fees are credited to the fee pool account once, after the last transaction, see credit_fee_pool()
+      struct fee_pool_credits_deferral
+      {
+         database& _db;
+         explicit fee_pool_credits_deferral( database& db ) : _db( db )
+         {
+            _db._fee_pool_credits.clear();
+            _db._defer_fee_pool_credits = true;
+         }
+         ~fee_pool_credits_deferral()
+         {
+            _db._defer_fee_pool_credits = false;
+            _db._fee_pool_credits.clear();
+         }
+      } deferral( *this );
+
+      for( size_t i = 0; i < next_block.transactions.size(); ++i )
+      {
+         /* We do not need to push the undo state for each transaction
+          * because they either all apply and are valid or the
+          * entire block fails to apply.  We only need an "undo" state
+          * for transactions when validating broadcast transactions or
+          * when building a block.
+          */
+         detail::with_skip_flags( *this, skip | skip_transaction_signatures, [&]()
+         {
+            _apply_transaction( next_block.transactions[i], validated_ids[i] );
+         });
+         ++_current_trx_in_block;
+      }
+      flush_fee_pool_credits();
    }
+   profiler.record_phase( "transactions", transactions_started );
 
-   update_global_dynamic_data(next_block);
-   update_signing_witness(signing_witness, next_block);
-   update_last_irreversible_block();
+   profiler.profile_phase( "update_global_dynamic_data", [&]() {
+      update_global_dynamic_data(next_block);
+      update_signing_witness(signing_witness, next_block);
+      update_last_irreversible_block();
+   } );
 
    // Are we at the maintenance interval?
    if( maint_needed )
-      perform_chain_maintenance(next_block, global_props);
+      profiler.profile_phase( "perform_chain_maintenance", [&]() { perform_chain_maintenance(next_block, global_props); } );
 
    create_block_summary(next_block);
-   clear_expired_transactions();
-   clear_expired_proposals();
-   clear_expired_orders();
-   update_expired_feeds();
-   update_withdraw_permissions();
+   profiler.profile_phase( "clear_expired_transactions", [&]() { clear_expired_transactions(); } );
+   profiler.profile_phase( "clear_expired_proposals", [&]() { clear_expired_proposals(); } );
+   profiler.profile_phase( "clear_expired_orders", [&]() { clear_expired_orders(); } );
+   profiler.profile_phase( "update_expired_feeds", [&]() { update_expired_feeds(); } );
+   profiler.profile_phase( "update_withdraw_permissions", [&]() { update_withdraw_permissions(); } );
 
    // n.b., update_maintenance_flag() happens this late
    // because get_slot_time() / get_slot_at_time() is needed above
@@ -605,28 +766,34 @@ void database::_apply_block( const signed_block& next_block )
    // update_global_dynamic_data() as perhaps these methods only need
    // to be called for header validation?
    update_maintenance_flag( maint_needed );
-   update_witnesses();
-   update_witness_schedule();
+   profiler.profile_phase( "update_witnesses", [&]() {
+      update_witnesses();
+      update_witness_schedule();
+   } );
 
-   reset_spending_limits();
+   profiler.profile_phase( "reset_spending_limits", [&]() { reset_spending_limits(); } );
 
    if ( global_props.parameters.enable_dascoin_queue )
-      mint_dascoin_rewards();
+      profiler.profile_phase( "mint_dascoin_rewards", [&]() { mint_dascoin_rewards(); } );
 
    if ( global_props.daspay_parameters.clearing_enabled )
-     daspay_clearing_start();
+     profiler.profile_phase( "daspay_clearing_start", [&]() { daspay_clearing_start(); } );
 
    if ( global_props.delayed_operations_resolver_enabled )
-     resolve_delayed_operations();
+     profiler.profile_phase( "resolve_delayed_operations", [&]() { resolve_delayed_operations(); } );
 
    if( !_node_property_object.debug_updates.empty() )
       apply_debug_updates();
 
    // notify observers that the block has been applied
-   notify_applied_block( next_block ); //emit
+   profiler.profile_phase( "notify_applied_block", [&]() { notify_applied_block( next_block ); } ); //emit
    _applied_ops.clear();
+   _unmaterialized_applied_ops.clear();
 
-   notify_changed_objects();
+   profiler.profile_phase( "notify_changed_objects", [&]() { notify_changed_objects(); } );
+
+   profiler.record_phase( "apply_block", block_started );
+   profiler.log_if_due();
 } FC_CAPTURE_AND_RETHROW( (next_block.block_num()) )  }
 
 processed_transaction database::apply_transaction(const signed_transaction& trx, uint32_t skip)
@@ -639,16 +806,69 @@ processed_transaction database::apply_transaction(const signed_transaction& trx,
    return result;
 }
 
-processed_transaction database::_apply_transaction(const signed_transaction& trx)
+void database::set_transaction_precompute_threads( uint16_t num_threads )
+{
+   _precompute_threads.clear();
+   for( uint16_t i = 0; i < num_threads; ++i )
+      _precompute_threads.push_back( std::make_shared<fc::thread>( "trx_precompute_" + fc::to_string(i) ) );
+}
+
+/**
+ * Validation and the transaction id only depend on the transaction itself, so they are computed for all of the
+ * block's transactions at once, each worker thread taking every n-th transaction. An unset entry means the work
+ * was not done or failed; _apply_transaction then redoes it in block order, so a failure is reported exactly as
+ * it would be without the worker threads.
+ *
+ * Waiting for the workers lets other tasks of this thread run, so this is done before the block is pushed rather
+ * than from _apply_block, where they would see a half applied block.
+ */
+void database::precompute_transactions( const signed_block& next_block )
+{
+   _precomputed_trx_ids.clear();
+   _precomputed_block_id = block_id_type();
+   const auto& trxs = next_block.transactions;
+   if( _precompute_threads.empty() || trxs.size() < 2 )
+      return;
+
+   vector<optional<transaction_id_type>> result( trxs.size() );
+
+   const size_t num_threads = std::min( _precompute_threads.size(), trxs.size() );
+   vector<fc::future<void>> work;
+   work.reserve( num_threads );
+   for( size_t t = 0; t < num_threads; ++t )
+      work.push_back( _precompute_threads[t]->async( [&trxs, &result, t, num_threads]() {
+         for( size_t i = t; i < trxs.size(); i += num_threads )
+         {
+            try
+            {
+               trxs[i].validate();
+               result[i] = trxs[i].id();
+            }
+            catch( ... )
+            {
+            }
+         }
+      }, "precompute_transactions" ) );
+   _execution_profiler.profile_phase( "precompute_transactions", [&]() {
+      for( auto& w : work )
+         w.wait();
+   } );
+   _precomputed_trx_ids = std::move( result );
+   _precomputed_block_id = next_block.id();
+}
+
+processed_transaction database::_apply_transaction(const signed_transaction& trx,
+                                                   const optional<transaction_id_type>& validated_id)
 { try {
    uint32_t skip = get_node_properties().skip_flags;
 
-   if( true || !(skip&skip_validate) )   /* issue #505 explains why this skip_flag is disabled */
+   // validated_id is only set once trx.validate() has passed, see precompute_transactions()
+   if( (true || !(skip&skip_validate)) && !validated_id.valid() )   /* issue #505 explains why this skip_flag is disabled */
       trx.validate();
 
    auto& trx_idx = get_mutable_index_type<transaction_index>();
    const chain_id_type& chain_id = get_chain_id();
-   auto trx_id = trx.id();
+   auto trx_id = validated_id.valid() ? *validated_id : trx.id();
    FC_ASSERT( (skip & skip_transaction_dupe_check) ||
               trx_idx.indices().get<by_trx_id>().find(trx_id) == trx_idx.indices().get<by_trx_id>().end() );
    transaction_evaluation_state eval_state(this);
@@ -657,9 +877,10 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
 
    if( !(skip & (skip_transaction_signatures | skip_authority_check) ) )
    {
-      auto get_active = [&]( account_id_type id ) { return &id(*this).active; };
-      auto get_owner  = [&]( account_id_type id ) { return &id(*this).owner;  };
-      trx.verify_authority( chain_id, get_active, get_owner, get_global_properties().parameters.max_authority_depth );
+      try {
+         _authority_cache.verify( trx.operations, trx.get_signature_keys( chain_id ), *this,
+                                  get_global_properties().parameters.max_authority_depth );
+      } FC_CAPTURE_AND_RETHROW( (trx) )
    }
 
    //Skip all manner of expiration and TaPoS checking if we're on block 1; It's impossible that the transaction is
@@ -693,13 +914,13 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
    eval_state.operation_results.reserve(trx.operations.size());
 
    //Finally process the operations
-   processed_transaction ptrx(trx);
    _current_op_in_trx = 0;
-   for( const auto& op : ptrx.operations )
+   for( const auto& op : trx.operations )
    {
-      eval_state.operation_results.emplace_back(apply_operation(eval_state, op));
+      eval_state.operation_results.emplace_back(_apply_operation(eval_state, op, _applied_ops_by_reference));
       ++_current_op_in_trx;
    }
+   processed_transaction ptrx(trx);
    ptrx.operation_results = std::move(eval_state.operation_results);
 
    //Make sure the temp account has no non-zero balances
@@ -711,6 +932,12 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
 } FC_CAPTURE_AND_RETHROW( (trx) ) }
 
 operation_result database::apply_operation(transaction_evaluation_state& eval_state, const operation& op)
+{
+   return _apply_operation( eval_state, op, false );
+}
+
+operation_result database::_apply_operation(transaction_evaluation_state& eval_state, const operation& op,
+                                            bool by_reference)
 { try {
    int i_which = op.which();
    uint64_t u_which = uint64_t( i_which );
@@ -721,8 +948,20 @@ operation_result database::apply_operation(transaction_evaluation_state& eval_st
    unique_ptr<op_evaluator>& eval = _operation_evaluators[ u_which ];
    if( !eval )
       assert( "No registered evaluator for this operation" && false );
-   auto op_id = push_applied_operation( op );
+   if( _defer_fee_pool_credits && !_fee_pool_credits.empty() )
+   {
+      // Only operations with a declared footprint that leaves out the fee pool account may run before the
+      // deferred fees are credited, see credit_fee_pool()
+      access_footprint footprint;
+      operation_get_access_footprint( op, footprint );
+      if( footprint.unbounded
+          || footprint.accounts.count( get_dynamic_global_properties().fee_pool_account_id ) )
+         flush_fee_pool_credits();
+   }
+   auto op_id = by_reference ? push_applied_operation_reference( op ) : push_applied_operation( op );
+   const auto started = _execution_profiler.start();
    auto result = eval->evaluate( eval_state, op, true );
+   _execution_profiler.record_operation( i_which, started );
    set_applied_operation_result( op_id, result );
    return result;
 } FC_CAPTURE_AND_RETHROW(  ) }
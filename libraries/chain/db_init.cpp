@@ -46,6 +46,7 @@
 #include <graphene/chain/special_authority_object.hpp>
 #include <graphene/chain/transaction_object.hpp>
 #include <graphene/chain/vesting_balance_object.hpp>
+#include <graphene/chain/vote_tally_index.hpp>
 #include <graphene/chain/upgrade_event_object.hpp>
 #include <graphene/chain/wire_object.hpp>
 #include <graphene/chain/wire_out_with_fee_object.hpp>
@@ -314,6 +315,7 @@ void database::initialize_indexes()
    auto acnt_index = add_index< primary_index<account_index> >();
    acnt_index->add_secondary_index<account_member_index>();
    acnt_index->add_secondary_index<account_referrer_index>();
+   _vote_tally_index = acnt_index->add_secondary_index<vote_tally_index>();
 
    add_index< primary_index<committee_member_index> >();
    add_index< primary_index<witness_index> >();
@@ -326,18 +328,18 @@ void database::initialize_indexes()
    prop_index->add_secondary_index<required_approval_index>();
 
    add_index< primary_index<withdraw_permission_index > >();
-   add_index< primary_index<vesting_balance_index> >();
+   add_index< primary_index<vesting_balance_index> >()->add_secondary_index<vote_tally_tracker<vesting_balance_object>>( _vote_tally_index );
    add_index< primary_index<worker_index> >();
    add_index< primary_index<balance_index> >();
    add_index< primary_index<blinded_balance_index> >();
 
    //Implementation object indexes
    add_index< primary_index<transaction_index                             > >();
-   add_index< primary_index<account_balance_index                         > >();
+   add_index< primary_index<account_balance_index                         > >()->add_secondary_index<vote_tally_tracker<account_balance_object>>( _vote_tally_index );
    add_index< primary_index<asset_bitasset_data_index                     > >();
    add_index< primary_index<simple_index<global_property_object          >> >();
    add_index< primary_index<simple_index<dynamic_global_property_object  >> >();
-   add_index< primary_index<account_stats_index                           > >();
+   add_index< primary_index<account_stats_index                           > >()->add_secondary_index<vote_tally_tracker<account_statistics_object>>( _vote_tally_index );
    add_index< primary_index<simple_index<asset_dynamic_data_object       >> >();
    add_index< primary_index<simple_index<block_summary_object            >> >();
    add_index< primary_index<simple_index<chain_property_object          > > >();
@@ -362,7 +364,7 @@ void database::initialize_indexes()
    add_index<primary_index<daspay_authority_index>>();
    add_index<primary_index<payment_service_provider_index>>();
    add_index<primary_index<das33_project_index>>();
-   add_index<primary_index<das33_pledge_holder_index>>();
+   add_index<primary_index<das33_pledge_holder_index>>()->add_secondary_index<das33_pledge_totals_index>();
    add_index<primary_index<delayed_operations_index>>();
 }
 
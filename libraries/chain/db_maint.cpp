@@ -44,6 +44,7 @@
 #include <graphene/chain/upgrade_event_object.hpp>
 #include <graphene/chain/vesting_balance_object.hpp>
 #include <graphene/chain/vote_count.hpp>
+#include <graphene/chain/vote_tally_index.hpp>
 #include <graphene/chain/witness_object.hpp>
 #include <graphene/chain/worker_object.hpp>
 
@@ -812,19 +813,6 @@ void database::perform_upgrades(const account_object& account, const upgrade_eve
 
 void database::perform_upgrades()
 {
-   class perform_upgrades_helper
-   {
-   public:
-     explicit perform_upgrades_helper(database& d, const upgrade_event_object& upgrade)
-         : d(d), upgrade(upgrade) {}
-
-     void operator()(const account_object& a) { d.perform_upgrades(a, upgrade); }
-
-   private:
-     database& d;
-     const upgrade_event_object& upgrade;
-   };
-
    // Helper lambda which returns true if upgrade should be executed:
    const auto should_execute_upgrade_event = [this](const upgrade_event_object& upgrade) -> bool {
      // If executed already, do not execute:
@@ -855,8 +843,24 @@ void database::perform_upgrades()
       });
 
       last_upgrade = *it;
-      perform_upgrades_helper upgrades_helper(*this, *it);
-      perform_helpers<account_index, by_name>(std::tie(upgrades_helper));
+
+      // Only accounts with a license activated before the cutoff time that can still be upgraded are affected.
+      // They are upgraded in name order, as that decides the order of queue submissions for charter licenses:
+      const auto& cutoff_time = it->cutoff_time.valid() ? *(it->cutoff_time) : it->execution_time;
+      const auto& license_idx = get_index_type<license_information_index>().indices().get<by_earliest_upgradeable_activation>();
+      vector<const account_object*> accounts;
+      for ( auto lit = license_idx.cbegin(), end = license_idx.upper_bound(cutoff_time); lit != end; ++lit )
+      {
+         const auto& account = lit->account(*this);
+         if ( account.license_information.valid() && *account.license_information == lit->get_id() )
+            accounts.push_back(&account);
+      }
+      std::sort(accounts.begin(), accounts.end(), [](const account_object* lhs, const account_object* rhs) {
+         return lhs->name < rhs->name;
+      });
+
+      for ( const account_object* account : accounts )
+         perform_upgrades(*account, *it);
    }
 }
 
@@ -945,7 +949,66 @@ void database::perform_chain_maintenance(const signed_block& next_block, const g
 
    } fee_helper(*this, gpo);
 
-   perform_helpers<account_index, by_name>(std::tie(tally_helper, fee_helper));
+   // Unless only members may vote, the tally is kept up to date as accounts and balances change, so only the
+   // accounts changed since the last maintenance are recounted. Paying out fees deposits cashback to other
+   // accounts, and those are recounted again when the sweep reaches them, like vote_tally_helper would see them.
+   struct incremental_tally_helper
+   {
+      database& d;
+
+      explicit incremental_tally_helper(database& d) : d(d) { d._vote_tally_index->update(d); }
+
+      void operator()(const account_object& a) { d._vote_tally_index->update(d, a.get_id()); }
+   };
+
+   const bool incremental_tally = gpo.parameters.count_non_member_votes;
+   if( !incremental_tally )
+      perform_helpers<account_index, by_name>(std::tie(tally_helper, fee_helper));
+   else if( _verify_vote_tally )
+   {
+      incremental_tally_helper incremental_helper(*this);
+      perform_helpers<account_index, by_name>(std::tie(tally_helper, incremental_helper, fee_helper));
+   }
+   else
+   {
+      incremental_tally_helper incremental_helper(*this);
+      perform_helpers<account_index, by_name>(std::tie(incremental_helper, fee_helper));
+   }
+
+   if( incremental_tally )
+   {
+      vector<uint64_t> vote_tally( gpo.next_available_vote_id );
+      vector<uint64_t> witness_count_histogram( gpo.parameters.maximum_witness_count / 2 + 1 );
+      vector<uint64_t> committee_count_histogram( gpo.parameters.maximum_committee_count / 2 + 1 );
+
+      // if they somehow managed to specify an illegal offset, ignore it
+      const auto& tallied_votes = _vote_tally_index->vote_tally;
+      std::copy_n( tallied_votes.begin(), std::min( tallied_votes.size(), vote_tally.size() ), vote_tally.begin() );
+      // votes for a number greater than the maximum are turned into votes for the maximum, as in vote_tally_helper
+      for( const auto& item : _vote_tally_index->stake_by_num_witness )
+         if( item.first <= gpo.parameters.maximum_witness_count )
+            witness_count_histogram[std::min( size_t(item.first / 2), witness_count_histogram.size() - 1 )] += item.second;
+      for( const auto& item : _vote_tally_index->stake_by_num_committee )
+         if( item.first <= gpo.parameters.maximum_committee_count )
+            committee_count_histogram[std::min( size_t(item.first / 2), committee_count_histogram.size() - 1 )] += item.second;
+
+      if( !_verify_vote_tally )
+      {
+         _vote_tally_buffer = std::move( vote_tally );
+         _witness_count_histogram_buffer = std::move( witness_count_histogram );
+         _committee_count_histogram_buffer = std::move( committee_count_histogram );
+         _total_voting_stake = _vote_tally_index->total_voting_stake;
+      }
+      else if( vote_tally != _vote_tally_buffer ||
+               witness_count_histogram != _witness_count_histogram_buffer ||
+               committee_count_histogram != _committee_count_histogram_buffer ||
+               _vote_tally_index->total_voting_stake != _total_voting_stake )
+      {
+         ++_vote_tally_mismatches;
+         elog( "Incremental vote tally does not match the recount at block ${n}, total voting stake ${t} vs ${r}",
+               ("n", next_block.block_num())("t", _vote_tally_index->total_voting_stake)("r", _total_voting_stake) );
+      }
+   }
 
    struct clear_canary {
       clear_canary(vector<uint64_t>& target): target(target){}
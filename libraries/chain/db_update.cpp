@@ -717,12 +717,14 @@ void database::resolve_delayed_operations()
     return;
 
   const auto& idx = get_index_type<delayed_operations_index>().indices().get<by_account>();
-  for (auto it = idx.cbegin(); it != idx.cend(); ++it)
+  for (auto it = idx.cbegin(); it != idx.cend(); )
   {
-    if (it->issued_time + it->skip <= head_block_time())
+    // Advance before removing, the removed element's iterator is invalidated:
+    const auto& delayed_op = *it++;
+    if (delayed_op.issued_time + delayed_op.skip <= head_block_time())
     {
-      it->op.visit(op_visitor(*this));
-      remove(*it);
+      delayed_op.op.visit(op_visitor(*this));
+      remove(delayed_op);
     }
   }
 
@@ -51,7 +51,7 @@ database& generic_evaluator::db()const { return trx_state->db(); }
       return result;
    } FC_CAPTURE_AND_RETHROW() }
 
-   void generic_evaluator::prepare_fee(account_id_type account_id, asset fee, operation op)
+   void generic_evaluator::prepare_fee(account_id_type account_id, const asset& fee, const operation& op)
    {
       const database& d = db();
       const auto& gbo = d.get_global_properties();
@@ -97,22 +97,7 @@ database& generic_evaluator::db()const { return trx_state->db(); }
          });
 
          /// put fee in fee pool or burn it if pool is not set
-         const auto& dynamic_properties = d.get_dynamic_global_properties();
-         if(dynamic_properties.fee_pool_account_id != account_id_type())
-         {
-            d.modify(d.get_balance_object(dynamic_properties.fee_pool_account_id, account_fee_balance_object->asset_type), [&](account_balance_object& b)
-            {
-               b.balance += fee_paid;
-            });
-         }
-         else // this means that we have to burn fee asset
-         {
-            const auto& fee_asset = account_fee_balance_object->asset_type(d);
-            d.modify(fee_asset.dynamic_asset_data_id(d), [&](asset_dynamic_data_object& addo)
-            {
-               addo.current_supply -= fee_paid;
-            });
-         }
+         d.credit_fee_pool( asset( fee_paid, account_fee_balance_object->asset_type ) );
       }
    } FC_CAPTURE_AND_RETHROW() }
 
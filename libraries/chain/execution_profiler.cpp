@@ -0,0 +1,164 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <graphene/chain/execution_profiler.hpp>
+#include <graphene/chain/protocol/operations.hpp>
+
+#include <fc/log/logger.hpp>
+
+#include <algorithm>
+
+namespace graphene { namespace chain {
+
+namespace {
+
+struct operation_name_visitor
+{
+   typedef string result_type;
+
+   template<typename Operation>
+   string operator()( const Operation& )const { return fc::get_typename<Operation>::name(); }
+};
+
+string operation_name( int which )
+{
+   operation op;
+   op.set_which( which );
+   return op.visit( operation_name_visitor() );
+}
+
+int64_t now_ns()
+{
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+} // anonymous namespace
+
+void execution_profiler::bucket_set::add( int64_t elapsed_ns )
+{
+   const uint64_t elapsed = std::max<int64_t>( elapsed_ns, 0 );
+   ++count;
+   total_ns += elapsed;
+   max_ns = std::max( max_ns, elapsed );
+
+   size_t bucket = 0;
+   for( uint64_t us = elapsed / 1000; us > 0 && bucket + 1 < histogram_buckets; us >>= 1 )
+      ++bucket;
+   ++histogram[bucket];
+}
+
+execution_profile_entry execution_profiler::bucket_set::to_entry( string name )const
+{
+   execution_profile_entry entry;
+   entry.name = std::move( name );
+   entry.count = count;
+   entry.total_us = total_ns / 1000;
+   entry.max_us = max_ns / 1000;
+   entry.histogram.assign( histogram.begin(), histogram.end() );
+   return entry;
+}
+
+void execution_profiler::enable( bool enabled )
+{
+   if( enabled && !this->enabled() )
+      reset();
+   _enabled.store( enabled, std::memory_order_relaxed );
+}
+
+void execution_profiler::reset()
+{
+   std::lock_guard<std::mutex> lock( _mutex );
+   _operations.clear();
+   _phases.clear();
+   _since = fc::time_point::now();
+   _last_log = _since;
+}
+
+void execution_profiler::record_operation( int which, int64_t started )
+{
+   if( started == 0 || which < 0 )
+      return;
+   const auto elapsed = now_ns() - started;
+
+   std::lock_guard<std::mutex> lock( _mutex );
+   if( _operations.size() <= size_t( which ) )
+      _operations.resize( which + 1 );
+   _operations[which].add( elapsed );
+}
+
+void execution_profiler::record_phase( const char* phase, int64_t started )
+{
+   if( started == 0 )
+      return;
+   const auto elapsed = now_ns() - started;
+
+   std::lock_guard<std::mutex> lock( _mutex );
+   _phases[phase].add( elapsed );
+}
+
+execution_profile execution_profiler::get_profile()const
+{
+   execution_profile result;
+   result.enabled = enabled();
+
+   std::lock_guard<std::mutex> lock( _mutex );
+   result.since = _since;
+   for( size_t which = 0; which < _operations.size(); ++which )
+      if( _operations[which].count > 0 )
+         result.operations.push_back( _operations[which].to_entry( operation_name( which ) ) );
+   for( const auto& phase : _phases )
+      result.phases.push_back( phase.second.to_entry( phase.first ) );
+   return result;
+}
+
+void execution_profiler::log_if_due()
+{
+   if( !enabled() || _log_interval.count() <= 0 )
+      return;
+   const auto now = fc::time_point::now();
+   if( now - _last_log < _log_interval )
+      return;
+   _last_log = now;
+
+   auto profile = get_profile();
+   auto by_total = []( const execution_profile_entry& a, const execution_profile_entry& b ) {
+      return a.total_us > b.total_us;
+   };
+   std::sort( profile.operations.begin(), profile.operations.end(), by_total );
+   std::sort( profile.phases.begin(), profile.phases.end(), by_total );
+
+   ilog( "Execution profile since ${s}:", ("s", profile.since) );
+   for( const auto& entry : profile.phases )
+      ilog( "   phase ${n}: ${c} calls, ${t} us total, ${m} us max",
+            ("n", entry.name)("c", entry.count)("t", entry.total_us)("m", entry.max_us) );
+   const size_t shown = std::min<size_t>( profile.operations.size(), 10 );
+   for( size_t i = 0; i < shown; ++i )
+   {
+      const auto& entry = profile.operations[i];
+      ilog( "   ${n}: ${c} calls, ${t} us total, ${m} us max",
+            ("n", entry.name)("c", entry.count)("t", entry.total_us)("m", entry.max_us) );
+   }
+}
+
+} } // graphene::chain
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <fc/container/flat.hpp>
+#include <graphene/chain/protocol/operations.hpp>
+#include <graphene/chain/protocol/transaction.hpp>
+#include <graphene/chain/protocol/types.hpp>
+
+namespace graphene { namespace chain {
+
+/**
+ * The state an operation may read and write when it is applied, declared per operation type without looking at
+ * the database. Bookkeeping done for every transaction (the transaction object, operation history) is not part of
+ * it, and neither is state only undeclared operations write, such as the order book.
+ */
+struct access_footprint
+{
+   /// Accounts whose own objects (account, statistics, balances, licence information) may be written
+   flat_set<account_id_type> accounts;
+   /// Other objects that may be written, e.g. the dynamic global properties
+   flat_set<object_id_type>  objects;
+   /// Objects that are read but not written, e.g. parameters kept in the dynamic global properties
+   flat_set<object_id_type>  reads;
+   /// Object types, as (space id, type id), new objects may be created in
+   flat_set<std::pair<uint8_t, uint8_t>> creates;
+   /// A fee is paid, which is credited to the fee pool account or burnt
+   bool                      pays_fee = false;
+   /// The operation type does not declare a footprint, so it must be assumed to touch anything
+   bool                      unbounded = false;
+
+   void merge( const access_footprint& other );
+};
+
+void operation_get_access_footprint(
+   const graphene::chain::operation& op,
+   graphene::chain::access_footprint& result );
+
+void transaction_get_access_footprint(
+   const graphene::chain::transaction& tx,
+   graphene::chain::access_footprint& result );
+
+/**
+ * Group footprints, e.g. of a block's transactions, into batches whose members do not conflict with each other:
+ * no member writes declared state another member reads or writes. Batches keep the original order of
+ * conflicting footprints. This does not make the members of a batch commute: new objects get their ids in order
+ * of application, so footprints with @ref access_footprint::creates in the same object type, as well as the
+ * per-transaction bookkeeping, only give the same ids when applied in their original order. An unbounded
+ * footprint gets a batch of its own. Fees credited to
+ * @p fee_pool_account are summed up per block (see database::credit_fee_pool), so footprints paying a fee only
+ * conflict with footprints writing that account. Without a fee pool account fees are burnt, and all footprints
+ * paying a fee conflict with each other.
+ *
+ * @return indices into @p footprints, batch by batch, in ascending order within a batch
+ */
+vector<vector<uint32_t>> build_conflict_free_batches(
+   const vector<access_footprint>& footprints,
+   account_id_type fee_pool_account = account_id_type() );
+
+} } // graphene::chain
+
+FC_REFLECT( graphene::chain::access_footprint, (accounts)(objects)(reads)(creates)(pays_fee)(unbounded) )
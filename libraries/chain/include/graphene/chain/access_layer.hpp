@@ -195,6 +195,18 @@ struct acc_id_vault_info_res : public acc_id_res {
     result_t result;
 };
 
+// One page of a query over many accounts, in account id order. Pass next as the start of the following query to get the
+// next page; next is not set on the last page.
+struct queue_submissions_with_pos_page {
+    vector<acc_id_queue_subs_w_pos_res> accounts;
+    optional<account_id_type> next;
+};
+
+struct vaults_info_page {
+    vector<acc_id_vault_info_res> vaults;
+    optional<account_id_type> next;
+};
+
 struct license_types_grouped_by_kind_res {
     struct license_name_and_id {
         string name;
@@ -303,6 +315,7 @@ class database_access_layer {
     vector<reward_queue_object> get_reward_queue_by_page(uint32_t from, uint32_t amount) const;
     acc_id_queue_subs_w_pos_res get_queue_submissions_with_pos(account_id_type account_id) const;
     vector<acc_id_queue_subs_w_pos_res> get_queue_submissions_with_pos_for_accounts(vector<account_id_type> ids) const;
+    queue_submissions_with_pos_page get_queue_submissions_with_pos_page(account_id_type start, uint32_t limit) const;
 
     // Requests:
     optional<issued_asset_record_object> get_issued_asset_record(const string& unique_id, asset_id_type asset_id) const;
@@ -310,6 +323,7 @@ class database_access_layer {
     // Vaults:
     optional<vault_info_res> get_vault_info(account_id_type vault_id) const;
     vector<acc_id_vault_info_res> get_vaults_info(vector<account_id_type> vault_ids) const;
+    vaults_info_page get_vaults_info_page(account_id_type start, uint32_t limit) const;
 
     // Assets:
     optional<asset_object> lookup_asset_symbol(const string& symbol_or_id) const;
@@ -412,6 +426,14 @@ FC_REFLECT(graphene::chain::vault_info_res,
 
 FC_REFLECT_DERIVED(graphene::chain::acc_id_vault_info_res, (graphene::chain::acc_id_res), (result))
 
+FC_REFLECT(graphene::chain::queue_submissions_with_pos_page,
+           (accounts)
+           (next))
+
+FC_REFLECT(graphene::chain::vaults_info_page,
+           (vaults)
+           (next))
+
 FC_REFLECT(graphene::chain::license_types_grouped_by_kind_res::license_name_and_id,
            (name)
            (id))
@@ -0,0 +1,76 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+#include <graphene/chain/protocol/authority.hpp>
+#include <graphene/chain/protocol/operations.hpp>
+
+#include <map>
+#include <tuple>
+
+namespace graphene { namespace chain {
+
+   class database;
+
+   /**
+    *  @brief Remembers which signing keys satisfied which required authorities, so transactions signed by the same
+    *  keys for the same accounts (custodians signing many transfers, for instance) skip rebuilding the sign state.
+    *
+    *  An entry records every authority consulted during the verification together with the account's
+    *  owner_change_counter or active_change_counter. It is only used while all of those authorities are unchanged.
+    *  The authority itself is compared as well, because account updates and roll backs replace authorities without
+    *  touching the counters, and undone changes can reuse a counter value for a different authority.
+    *
+    *  Only successful verifications are remembered, failures always go through verify_authority() and report the
+    *  same errors as before.
+    */
+   class authority_verification_cache
+   {
+      public:
+         /** the cache is emptied when it grows beyond this many entries */
+         static const size_t max_entries = 10000;
+
+         /** same as verify_authority() with the database's authorities, skipped if an equivalent one succeeded */
+         void verify( const vector<operation>& ops, const flat_set<public_key_type>& sigs, const database& db,
+                      uint32_t max_recursion );
+
+         void clear() { _entries.clear(); }
+         size_t size()const { return _entries.size(); }
+
+      private:
+         struct consulted_authority
+         {
+            account_id_type account;
+            bool            owner = false;
+            uint32_t        version = 0;
+            authority       auth;
+         };
+
+         typedef std::tuple<flat_set<public_key_type>, flat_set<account_id_type>, flat_set<account_id_type>, uint32_t> key_type;
+
+         static bool unchanged( const vector<consulted_authority>& consulted, const database& db );
+
+         std::map<key_type, vector<consulted_authority>> _entries;
+   };
+
+} } // graphene::chain
@@ -29,6 +29,7 @@
 #include <graphene/db/generic_index.hpp>
 #include <graphene/db/object.hpp>
 #include <boost/multi_index/composite_key.hpp>
+#include <tuple>
 
 namespace graphene { namespace chain {
 
@@ -134,6 +135,7 @@ namespace graphene { namespace chain {
 
   struct by_user;
   struct by_project;
+  struct by_project_phase;
 
   using das33_pledge_holder_multi_index_type = multi_index_container<
     das33_pledge_holder_object,
@@ -158,12 +160,48 @@ namespace graphene { namespace chain {
           member< das33_pledge_holder_object, das33_project_id_type, &das33_pledge_holder_object::project_id >,
           member< object, object_id_type, &object::id >
         >
+      >,
+      ordered_unique<
+        tag<by_project_phase>,
+        composite_key<
+          das33_pledge_holder_object,
+          member< das33_pledge_holder_object, das33_project_id_type, &das33_pledge_holder_object::project_id >,
+          member< das33_pledge_holder_object, share_type, &das33_pledge_holder_object::phase_number >,
+          member< object, object_id_type, &object::id >
+        >
       >
     >
   >;
 
   using das33_pledge_holder_index = generic_index<das33_pledge_holder_object, das33_pledge_holder_multi_index_type>;
 
+  /**
+   * @brief This secondary index keeps running totals of the pledges currently held, so pledge limits and project
+   * statistics don't have to rescan the pledges.
+   *
+   * Totals follow the pledge holder objects: they grow when a pledge is made and shrink when its holder is removed
+   * (distributed or rejected), also when that is undone.
+   */
+  class das33_pledge_totals_index : public secondary_index
+  {
+    public:
+      virtual void object_inserted( const object& obj ) override;
+      virtual void object_removed( const object& obj ) override;
+      virtual void about_to_modify( const object& before ) override;
+      virtual void object_modified( const object& after ) override;
+
+      /** sum of base_expected of the user's pledges to the project in the given phase */
+      share_type get_user_round_total( account_id_type account, das33_project_id_type project, share_type phase_number ) const;
+      /** pledged amounts to the project, one entry per pledged asset */
+      vector<asset> get_project_totals( das33_project_id_type project ) const;
+
+    private:
+      void apply( const das33_pledge_holder_object& pledge, bool add );
+
+      map<std::tuple<account_id_type, das33_project_id_type, share_type>, share_type> _user_round_totals;
+      map<das33_project_id_type, map<asset_id_type, share_type>>                       _project_totals;
+  };
+
   struct by_project_name;
   typedef multi_index_container<
       das33_project_object,
@@ -25,11 +25,13 @@
 #include <graphene/chain/global_property_object.hpp>
 #include <graphene/chain/node_property_object.hpp>
 #include <graphene/chain/account_object.hpp>
+#include <graphene/chain/authority_verification_cache.hpp>
 #include <graphene/chain/asset_object.hpp>
 #include <graphene/chain/fork_database.hpp>
 #include <graphene/chain/block_database.hpp>
 #include <graphene/chain/genesis_state.hpp>
 #include <graphene/chain/evaluator.hpp>
+#include <graphene/chain/execution_profiler.hpp>
 #include <graphene/chain/license_objects.hpp>
 
 #include <graphene/db/object_database.hpp>
@@ -42,13 +44,18 @@
 
 #include <fc/log/logger.hpp>
 
+#include <boost/thread/shared_mutex.hpp>
+
 #include <map>
 
+namespace fc { class thread; }
+
 namespace graphene { namespace chain {
    using graphene::db::abstract_object;
    using graphene::db::object;
    class op_evaluator;
    class transaction_evaluation_state;
+   class vote_tally_index;
 
    struct budget_record;
 
@@ -160,9 +167,75 @@ namespace graphene { namespace chain {
             const fc::ecc::private_key& block_signing_private_key
             );
 
+         /**
+          *  Assemble a candidate for the block @ref generate_block will produce at @p when, ahead of the slot.
+          *
+          *  The candidate is built from the already applied pending transactions, so nothing is re-applied, and it
+          *  keeps growing as new transactions are pushed. It is discarded as soon as the pending state is reset (a
+          *  block is pushed or popped). If it is still valid when @ref generate_block is called for the same slot
+          *  and witness, it is used instead of rebuilding the pending state.
+          */
+         void assemble_speculative_block( const fc::time_point_sec when, witness_id_type witness_id );
+
          void pop_block();
          void clear_pending();
 
+         /**
+          *  At maintenance, recount all votes as well and compare the result with the incrementally maintained
+          *  tally. On a mismatch the recount is used and @ref get_vote_tally_mismatches is incremented.
+          */
+         void set_vote_tally_verification( bool enabled ) { _verify_vote_tally = enabled; }
+         uint32_t get_vote_tally_mismatches()const { return _vote_tally_mismatches; }
+
+         /**
+          *  Allow read-only queries to run on other threads through @ref with_read_lock.
+          *
+          *  While enabled, the calls that modify the state (pushing and popping blocks and transactions, generating
+          *  blocks, clearing the pending state) hold the state lock exclusively, so a reader sees the state as it is
+          *  between two such calls and never in the middle of one. All of those calls must stay on one thread.
+          */
+         void enable_concurrent_reads( bool enabled ) { _concurrent_reads_enabled = enabled; }
+         bool concurrent_reads_enabled()const { return _concurrent_reads_enabled; }
+
+         /**
+          *  Timing of operation evaluation and of the steps of block application, see @ref execution_profiler.
+          *  Disabled by default.
+          */
+         execution_profiler& get_execution_profiler() { return _execution_profiler; }
+         const execution_profiler& get_execution_profiler()const { return _execution_profiler; }
+
+         /**
+          *  Results of transaction authority checks, reused for transactions signed by the same keys for the same
+          *  accounts while their authorities are unchanged, see @ref authority_verification_cache.
+          */
+         authority_verification_cache& get_authority_verification_cache() { return _authority_cache; }
+         const authority_verification_cache& get_authority_verification_cache()const { return _authority_cache; }
+
+         /**
+          *  Validate a block's transactions and compute their ids on @p num_threads worker threads before the
+          *  transactions are applied one by one in block order. Zero, the default, does all of it in block order.
+          */
+         void set_transaction_precompute_threads( uint16_t num_threads );
+
+         /**
+          *  Validate @p next_block's transactions and compute their ids on the precompute worker threads, for use
+          *  when the block is applied next. Waits for the workers, so it must be called before @ref push_block and
+          *  never while a block or transaction is being applied.
+          */
+         void precompute_transactions( const signed_block& next_block );
+
+         /**
+          *  Call @p callback with the state lock held shared. Does no locking unless concurrent reads are enabled.
+          */
+         template<typename Lambda>
+         auto with_read_lock( Lambda&& callback ) -> decltype( callback() )
+         {
+            if( !_concurrent_reads_enabled )
+               return callback();
+            boost::shared_lock<boost::shared_mutex> lock( _state_mutex );
+            return callback();
+         }
+
          /**
           *  This method is used to track appied operations during the evaluation of a block, these
           *  operations should include any operation actually included in a transaction as well
@@ -175,6 +248,7 @@ namespace graphene { namespace chain {
          uint32_t  push_applied_operation( const operation& op );
          void      set_applied_operation_result( uint32_t op_id, const operation_result& r );
          void      applied_ops_to_virtual_ops();
+         /// Operations recorded by reference are copied into their operation_history_object on the first call
          const vector<optional< operation_history_object > >& get_applied_operations()const;
          vector<optional< operation_history_object > > get_virtual_ops_and_clear_collection();
 
@@ -398,6 +472,16 @@ namespace graphene { namespace chain {
           */
          void adjust_cycle_balance(account_id_type account, share_type delta);
 
+         /**
+          * @brief Credit a paid fee to the fee pool account, or burn it if no fee pool account is set.
+          *
+          * While a block's transactions are applied, credits to the fee pool account are summed up per asset and
+          * only applied by @ref flush_fee_pool_credits: after the last transaction, and before any operation that
+          * could see the fee pool account's balances.
+          */
+         void credit_fee_pool(const asset& fee);
+         void flush_fee_pool_credits();
+
          /**
           * Issue new cycles to the account. This will increase the global supply of cycles in the system.
           * @param account ID of the account to benefit the cycles.
@@ -614,6 +698,29 @@ namespace graphene { namespace chain {
 
       private:
          optional<undo_database::session>       _pending_tx_session;
+
+         /// Candidate block assembled ahead of our slot, see @ref assemble_speculative_block
+         optional<signed_block>                 _speculative_block;
+         size_t                                 _speculative_block_size = 0;
+
+         /// Held shared by readers and exclusively while the state is modified, see @ref enable_concurrent_reads
+         struct state_write_lock;
+         boost::shared_mutex                    _state_mutex;
+         bool                                   _concurrent_reads_enabled = false;
+         uint32_t                               _state_write_depth = 0;
+
+         /// Fee pool credits not applied yet, see @ref credit_fee_pool
+         flat_map<asset_id_type, share_type>    _fee_pool_credits;
+         bool                                   _defer_fee_pool_credits = false;
+
+         execution_profiler                     _execution_profiler;
+         authority_verification_cache           _authority_cache;
+
+         /// Worker threads of @ref precompute_transactions, see @ref set_transaction_precompute_threads
+         vector<std::shared_ptr<fc::thread>>    _precompute_threads;
+         /// Results of the last @ref precompute_transactions, an unset entry means the work is redone in block order
+         block_id_type                          _precomputed_block_id;
+         vector<optional<transaction_id_type>>  _precomputed_trx_ids;
          vector< unique_ptr<op_evaluator> >     _operation_evaluators;
 
          template<class Index>
@@ -627,8 +734,16 @@ namespace graphene { namespace chain {
          processed_transaction apply_transaction( const signed_transaction& trx, uint32_t skip = skip_nothing );
          operation_result      apply_operation( transaction_evaluation_state& eval_state, const operation& op );
       private:
+         /// If @p by_reference, @p op must stay valid until the applied operations are cleared
+         operation_result      _apply_operation( transaction_evaluation_state& eval_state, const operation& op,
+                                                 bool by_reference );
+         uint32_t              push_applied_operation_reference( const operation& op );
+         uint32_t              init_applied_operation();
+         void                  materialize_applied_operations()const;
          void                  _apply_block( const signed_block& next_block );
-         processed_transaction _apply_transaction( const signed_transaction& trx );
+         processed_transaction _apply_transaction( const signed_transaction& trx,
+                                                   const optional<transaction_id_type>& validated_id = optional<transaction_id_type>() );
+         void                  append_to_speculative_block( const processed_transaction& trx );
 
          ///Steps involved in applying a new block
          ///@{
@@ -710,7 +825,10 @@ private:
           * order they occur and is cleared after the applied_block signal is
           * emited.
           */
-         vector<optional<operation_history_object> >  _applied_ops;
+         mutable vector<optional<operation_history_object> >  _applied_ops;
+         /// Indices into _applied_ops whose operation is still only referenced, see materialize_applied_operations()
+         mutable vector<std::pair<uint32_t, const operation*>> _unmaterialized_applied_ops;
+         bool                                         _applied_ops_by_reference = false;
 
          /**
           * Contains the set of virtual ops that are in the process of being applied from
@@ -729,6 +847,10 @@ private:
          vector<uint64_t>                  _committee_count_histogram_buffer;
          uint64_t                          _total_voting_stake;
 
+         vote_tally_index*                 _vote_tally_index = nullptr;
+         bool                              _verify_vote_tally = false;
+         uint32_t                          _vote_tally_mismatches = 0;
+
          flat_map<uint32_t,block_id_type>  _checkpoints;
 
          node_property_object              _node_property_object;
@@ -83,7 +83,7 @@ namespace graphene { namespace chain {
        *
        * In particular, core_fee_paid field is set by prepare_fee().
        */
-      void prepare_fee(account_id_type account_id, asset fee, operation op);
+      void prepare_fee(account_id_type account_id, const asset& fee, const operation& op);
 
       object_id_type get_relative_id( object_id_type rel_id )const;
 
@@ -153,7 +153,7 @@ namespace graphene { namespace chain {
            }
          }
 
-         prepare_fee(op.fee_payer(), op.fee, op);
+         prepare_fee(op.fee_payer(), op.fee, o);
 
          return eval->do_evaluate(op);
       }
@@ -0,0 +1,130 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+#include <graphene/chain/protocol/types.hpp>
+
+#include <fc/reflect/reflect.hpp>
+#include <fc/time.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace graphene { namespace chain {
+
+   /**
+    *  @brief Time spent in one operation type or block application phase.
+    *
+    *  histogram[i] counts the calls that took less than 2^i microseconds (and at least 2^(i-1)), the last bucket
+    *  also counts everything slower.
+    */
+   struct execution_profile_entry
+   {
+      string           name;
+      uint64_t         count = 0;
+      uint64_t         total_us = 0;
+      uint64_t         max_us = 0;
+      vector<uint64_t> histogram;
+   };
+
+   struct execution_profile
+   {
+      bool                            enabled = false;
+      /// Time covered by the profile, since profiling was enabled or reset
+      fc::time_point                  since;
+      vector<execution_profile_entry> operations;
+      vector<execution_profile_entry> phases;
+   };
+
+   /**
+    *  @brief Aggregates how long operation evaluation and the steps of block application take.
+    *
+    *  While disabled, @ref start returns zero and the record calls return right away, so the instrumented code
+    *  only pays for one relaxed atomic load. Samples are taken on the thread applying blocks; @ref get_profile may
+    *  be called from any thread.
+    */
+   class execution_profiler
+   {
+      public:
+         static constexpr size_t histogram_buckets = 24;
+
+         void enable( bool enabled );
+         bool enabled()const { return _enabled.load( std::memory_order_relaxed ); }
+         void reset();
+
+         /// Log a summary every @p interval, checked by @ref log_if_due. Zero disables logging.
+         void set_log_interval( fc::microseconds interval ) { _log_interval = interval; }
+         void log_if_due();
+
+         /// Returns the start tick of a sample, zero when profiling is disabled
+         int64_t start()const
+         {
+            if( !enabled() )
+               return 0;
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now().time_since_epoch() ).count();
+         }
+
+         void record_operation( int which, int64_t started );
+         void record_phase( const char* phase, int64_t started );
+
+         /// Call @p callback and record the time it took as @p phase
+         template<typename Lambda>
+         void profile_phase( const char* phase, Lambda&& callback )
+         {
+            const auto started = start();
+            callback();
+            record_phase( phase, started );
+         }
+
+         execution_profile get_profile()const;
+
+      private:
+         struct bucket_set
+         {
+            uint64_t count = 0;
+            uint64_t total_ns = 0;
+            uint64_t max_ns = 0;
+            std::array<uint64_t, histogram_buckets> histogram{};
+
+            void add( int64_t elapsed_ns );
+            execution_profile_entry to_entry( string name )const;
+         };
+
+         std::atomic<bool>                _enabled{false};
+         mutable std::mutex               _mutex;
+         fc::time_point                   _since;
+         vector<bucket_set>               _operations;
+         std::map<string, bucket_set>     _phases;
+
+         fc::microseconds                 _log_interval;
+         fc::time_point                   _last_log;
+   };
+
+} } // graphene::chain
+
+FC_REFLECT( graphene::chain::execution_profile_entry, (name)(count)(total_us)(max_us)(histogram) )
+FC_REFLECT( graphene::chain::execution_profile, (enabled)(since)(operations)(phases) )
@@ -195,6 +195,16 @@ namespace graphene { namespace chain {
         }
       }
 
+      // Activation time of the earliest license that still has balance upgrades left, maximum if there is none:
+      time_point_sec earliest_upgradeable_activation() const
+      {
+        time_point_sec earliest = time_point_sec::maximum();
+        for (const auto& lic_history: history)
+          if (lic_history.balance_upgrade.has_remaining_upgrades() && lic_history.activated_at < earliest)
+            earliest = lic_history.activated_at;
+        return earliest;
+      }
+
       optional<license_history_record> get_license(const license_type_id_type& license_type) const
       {
         optional<license_history_record> license{};
@@ -285,6 +295,7 @@ namespace graphene { namespace chain {
   ///////////////////////////////
 
   struct by_account_id;
+  struct by_earliest_upgradeable_activation;
   typedef multi_index_container<
     license_information_object,
     indexed_by<
@@ -298,6 +309,10 @@ namespace graphene { namespace chain {
               member< license_information_object, account_id_type, &license_information_object::account >,
               member< object, object_id_type, &object::id >
           >
+      >,
+      ordered_non_unique<
+        tag<by_earliest_upgradeable_activation>,
+        const_mem_fun< license_information_object, time_point_sec, &license_information_object::earliest_upgradeable_activation >
       >
     >
   > license_information_multi_index_type;
@@ -0,0 +1,118 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/vesting_balance_object.hpp>
+
+namespace graphene { namespace chain {
+
+   class database;
+
+   /**
+    *  @brief This secondary index keeps the stake voting for each vote id up to date between maintenance intervals.
+    *
+    *  Changes to accounts, core balances, account statistics and vesting balances only mark the stake accounts
+    *  they affect, and @ref update recounts just those. What each stake account contributed last time is kept, so
+    *  it can be taken back out exactly, also after the changes that led to it have been undone.
+    *
+    *  Membership is not considered, the tally is only valid when non-member votes are counted.
+    */
+   class vote_tally_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /** recount the stake of this account at the next update */
+         void mark_dirty( account_id_type stake_account );
+
+         /** recount the accounts marked since the last update, or all of them the first time */
+         void update( const database& db );
+         /** recount this account now if it has been marked */
+         void update( const database& db, account_id_type stake_account );
+
+         /** stake voting for each vote id, indexed by vote id instance */
+         vector<uint64_t>           vote_tally;
+         /** stake of the accounts wishing for each number of witnesses and committee members */
+         map<uint16_t, uint64_t>    stake_by_num_witness;
+         map<uint16_t, uint64_t>    stake_by_num_committee;
+         uint64_t                   total_voting_stake = 0;
+
+      private:
+         struct contribution
+         {
+            uint64_t                stake = 0;
+            account_id_type         opinion_account;
+            flat_set<vote_id_type>  votes;
+            uint16_t                num_witness = 0;
+            uint16_t                num_committee = 0;
+         };
+
+         void recount( const database& db, account_id_type stake_account_id );
+         void apply( const contribution& c, bool add );
+
+         bool                                          _initialized = false;
+         set<account_id_type>                          _dirty;
+         map<account_id_type, contribution>            _contributions;
+         map<account_id_type, set<account_id_type>>    _stakers_by_opinion_account;
+   };
+
+   /** the stake account whose vote weight depends on the object, if any */
+   inline optional<account_id_type> vote_tally_stake_account( const account_balance_object& o )
+   {
+      if( o.asset_type == asset_id_type() )
+         return o.owner;
+      return {};
+   }
+   inline optional<account_id_type> vote_tally_stake_account( const account_statistics_object& o ) { return o.owner; }
+   inline optional<account_id_type> vote_tally_stake_account( const vesting_balance_object& o ) { return o.owner; }
+
+   /**
+    *  @brief Marks the owner of any changed object in the index it is attached to for recounting
+    *  in the @ref vote_tally_index.
+    */
+   template<typename ObjectType>
+   class vote_tally_tracker : public secondary_index
+   {
+      public:
+         explicit vote_tally_tracker( vote_tally_index* tally ) : _tally( *tally ) {}
+
+         virtual void object_inserted( const object& obj ) override { mark( obj ); }
+         virtual void object_removed( const object& obj ) override { mark( obj ); }
+         virtual void object_modified( const object& after  ) override { mark( after ); }
+
+      private:
+         void mark( const object& obj )
+         {
+            auto stake_account = vote_tally_stake_account( static_cast<const ObjectType&>( obj ) );
+            if( stake_account.valid() )
+               _tally.mark_dirty( *stake_account );
+         }
+
+         vote_tally_index& _tally;
+   };
+
+} } // graphene::chain
@@ -0,0 +1,135 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <graphene/chain/vote_tally_index.hpp>
+#include <graphene/chain/database.hpp>
+
+namespace graphene { namespace chain {
+
+void vote_tally_index::object_inserted( const object& obj )
+{
+   mark_dirty( static_cast<const account_object&>( obj ).get_id() );
+}
+
+void vote_tally_index::object_removed( const object& obj )
+{
+   about_to_modify( obj );
+}
+
+void vote_tally_index::about_to_modify( const object& before )
+{
+   // the accounts using this one's opinions are affected by a change to it as well
+   const account_id_type account_id = static_cast<const account_object&>( before ).get_id();
+   mark_dirty( account_id );
+   auto stakers = _stakers_by_opinion_account.find( account_id );
+   if( stakers != _stakers_by_opinion_account.end() )
+      _dirty.insert( stakers->second.begin(), stakers->second.end() );
+}
+
+void vote_tally_index::object_modified( const object& after )
+{
+   mark_dirty( static_cast<const account_object&>( after ).get_id() );
+}
+
+void vote_tally_index::mark_dirty( account_id_type stake_account )
+{
+   if( _initialized )
+      _dirty.insert( stake_account );
+}
+
+void vote_tally_index::update( const database& db )
+{
+   if( !_initialized )
+   {
+      for( const account_object& account : db.get_index_type<account_index>().indices() )
+         _dirty.insert( account.get_id() );
+      _initialized = true;
+   }
+
+   for( const account_id_type& stake_account_id : _dirty )
+      recount( db, stake_account_id );
+   _dirty.clear();
+}
+
+void vote_tally_index::update( const database& db, account_id_type stake_account )
+{
+   if( _dirty.erase( stake_account ) )
+      recount( db, stake_account );
+}
+
+void vote_tally_index::recount( const database& db, account_id_type stake_account_id )
+{
+   auto itr = _contributions.find( stake_account_id );
+   if( itr != _contributions.end() )
+   {
+      apply( itr->second, false );
+      _stakers_by_opinion_account[itr->second.opinion_account].erase( stake_account_id );
+      _contributions.erase( itr );
+   }
+
+   const account_object* stake_account = db.find( stake_account_id );
+   if( stake_account == nullptr )
+      return;
+
+   // same as vote_tally_helper in db_maint.cpp
+   const account_object& opinion_account =
+         (stake_account->options.voting_account ==
+          GRAPHENE_PROXY_TO_SELF_ACCOUNT)? *stake_account
+                            : db.get(stake_account->options.voting_account);
+
+   contribution c;
+   c.stake = stake_account->statistics(db).total_core_in_orders.value
+         + (stake_account->cashback_vb.valid() ? (*stake_account->cashback_vb)(db).balance.amount.value: 0)
+         + db.get_balance(stake_account_id, asset_id_type()).amount.value;
+   c.opinion_account = opinion_account.get_id();
+   c.votes = opinion_account.options.votes;
+   c.num_witness = opinion_account.options.num_witness;
+   c.num_committee = opinion_account.options.num_committee;
+
+   apply( c, true );
+   _stakers_by_opinion_account[c.opinion_account].insert( stake_account_id );
+   _contributions.emplace( stake_account_id, std::move( c ) );
+}
+
+void vote_tally_index::apply( const contribution& c, bool add )
+{
+   const auto adjust = [&c, add]( uint64_t& target ) {
+      if( add )
+         target += c.stake;
+      else
+         target -= c.stake;
+   };
+
+   for( vote_id_type id : c.votes )
+   {
+      if( id.instance() >= vote_tally.size() )
+         vote_tally.resize( id.instance() + 1 );
+      adjust( vote_tally[id.instance()] );
+   }
+   adjust( stake_by_num_witness[c.num_witness] );
+   adjust( stake_by_num_committee[c.num_committee] );
+   adjust( total_voting_stake );
+}
+
+} } // graphene::chain
@@ -49,6 +49,13 @@
 
 #define GRAPHENE_NET_PEER_DISCONNECT_TIMEOUT                 20
 
+/**
+ * How often (in seconds) we measure the round trip delay to each active peer.
+ * Busy peers never trigger a keepalive, so without this their latency would
+ * only be known from the time of connection.
+ */
+#define GRAPHENE_NET_PEER_ROUND_TRIP_PROBE_INTERVAL          30
+
 /* uncomment next line to use testnet seed ip and port */
 //#define GRAPHENE_TEST_NETWORK                                1
 
@@ -84,6 +91,14 @@
 
 #define GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING      200
 
+/**
+ * When parallel sync is enabled, a peer that has delivered no sync block for
+ * this many milliseconds (or for four times its measured per-block delivery
+ * time, whichever is longer) while it has requests outstanding is considered
+ * stalled, and its outstanding requests are requested from other peers.
+ */
+#define GRAPHENE_NET_MIN_SYNC_ITEM_REQUEST_TIMEOUT_MS        500
+
 /**
  * During normal operation, how many items will be fetched from each
  * peer at a time.  This will only come into play when the network
@@ -86,6 +86,9 @@ namespace graphene { namespace net {
     check_firewall_reply_message_type            = 5015,
     get_current_connections_request_message_type = 5016,
     get_current_connections_reply_message_type   = 5017,
+    compact_block_message_type                   = 5018,
+    fetch_compact_block_transactions_message_type = 5019,
+    compact_block_transactions_message_type      = 5020,
     core_message_type_last                       = 5099
   };
 
@@ -115,6 +118,49 @@ namespace graphene { namespace net {
 
    };
 
+  struct compact_block_transaction
+  {
+    item_hash_t                                     transaction_message_hash; /// hash of the trx_message the transaction was relayed in
+    std::vector<graphene::chain::operation_result>  operation_results;
+  };
+
+  /**
+   * Sent instead of a block_message to peers that support compact block relay.  The peer
+   * rebuilds the block from the transactions in its own message cache and asks for the
+   * missing ones with a fetch_compact_block_transactions_message.
+   */
+  struct compact_block_message
+  {
+    static const core_message_type_enum type;
+
+    item_hash_t                               block_message_hash; /// hash of the block_message this stands for
+    graphene::chain::signed_block_header      header;
+    std::vector<compact_block_transaction>    transactions;
+  };
+
+  struct fetch_compact_block_transactions_message
+  {
+    static const core_message_type_enum type;
+
+    item_hash_t            block_message_hash;
+    std::vector<uint32_t>  transaction_indices;
+
+    fetch_compact_block_transactions_message() {}
+    fetch_compact_block_transactions_message(const item_hash_t& block_message_hash,
+                                             const std::vector<uint32_t>& transaction_indices) :
+      block_message_hash(block_message_hash),
+      transaction_indices(transaction_indices)
+    {}
+  };
+
+  struct compact_block_transactions_message
+  {
+    static const core_message_type_enum type;
+
+    item_hash_t                      block_message_hash;
+    std::vector<signed_transaction>  transactions; /// in the order they were requested
+  };
+
   struct item_ids_inventory_message
   {
     static const core_message_type_enum type;
@@ -424,10 +470,22 @@ FC_REFLECT_ENUM( graphene::net::core_message_type_enum,
                  (check_firewall_reply_message_type)
                  (get_current_connections_request_message_type)
                  (get_current_connections_reply_message_type)
+                 (compact_block_message_type)
+                 (fetch_compact_block_transactions_message_type)
+                 (compact_block_transactions_message_type)
                  (core_message_type_last) )
 
 FC_REFLECT( graphene::net::trx_message, (trx) )
 FC_REFLECT( graphene::net::block_message, (block)(block_id) )
+FC_REFLECT( graphene::net::compact_block_transaction, (transaction_message_hash)
+                                                 (operation_results) )
+FC_REFLECT( graphene::net::compact_block_message, (block_message_hash)
+                                             (header)
+                                             (transactions) )
+FC_REFLECT( graphene::net::fetch_compact_block_transactions_message, (block_message_hash)
+                                                                (transaction_indices) )
+FC_REFLECT( graphene::net::compact_block_transactions_message, (block_message_hash)
+                                                          (transactions) )
 
 FC_REFLECT( graphene::net::item_id, (item_type)
                                (item_hash) )
@@ -180,6 +180,32 @@ namespace graphene { namespace net {
       fc::variant_object info;
    };
 
+   /**
+    *  Transfer statistics for a connected peer, as used to decide which peers
+    *  to request blocks and transactions from.
+    */
+   struct peer_telemetry
+   {
+      fc::ip::endpoint host;
+      node_id_t        node_id;
+      /** latency of the link, measured periodically */
+      fc::microseconds round_trip_delay;
+      /** moving average of the time from requesting an item to receiving it during normal operation */
+      fc::microseconds item_service_time;
+      /** moving average of the time the peer takes to deliver each sync block we request */
+      fc::microseconds sync_item_service_time;
+      /** bytes per second, averaged over roughly the last minute */
+      uint32_t         download_rate = 0;
+      uint32_t         upload_rate = 0;
+      uint64_t         items_received = 0;
+      uint64_t         sync_items_received = 0;
+      uint32_t         item_requests_failed = 0;
+      uint32_t         sync_item_requests_failed = 0;
+      /** requests currently awaiting an answer */
+      uint32_t         items_in_flight = 0;
+      uint32_t         sync_items_in_flight = 0;
+   };
+
    /**
     *  @class node
     *  @brief provides application independent P2P broadcast and data synchronization
@@ -249,6 +275,11 @@ namespace graphene { namespace net {
          */
         std::vector<peer_status> get_connected_peers() const;
 
+        /**
+         *  @return latency, throughput and failure statistics for each peer that is currently connected
+         */
+        std::vector<peer_telemetry> get_peer_telemetry() const;
+
         /** return the number of peers we're actively connected to */
         virtual uint32_t get_connection_count() const;
 
@@ -326,3 +357,7 @@ namespace graphene { namespace net {
 
 FC_REFLECT(graphene::net::message_propagation_data, (received_time)(validated_time)(originating_peer));
 FC_REFLECT( graphene::net::peer_status, (version)(host)(info) );
+FC_REFLECT( graphene::net::peer_telemetry, (host)(node_id)(round_trip_delay)(item_service_time)(sync_item_service_time)
+                                           (download_rate)(upload_rate)(items_received)(sync_items_received)
+                                           (item_requests_failed)(sync_item_requests_failed)
+                                           (items_in_flight)(sync_items_in_flight) );
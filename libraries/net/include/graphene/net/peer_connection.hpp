@@ -178,6 +178,7 @@ namespace graphene { namespace net
       firewalled_state is_firewalled;
       fc::microseconds clock_offset;
       fc::microseconds round_trip_delay;
+      fc::time_point last_round_trip_probe_time; /// when we last sent this peer a current_time_request_message
 
       our_connection_state our_state;
       bool they_have_requested_close;
@@ -226,8 +227,10 @@ namespace graphene { namespace net
       bool peer_needs_sync_items_from_us;
       bool we_need_sync_items_from_peer;
       fc::optional<boost::tuple<std::vector<item_hash_t>, fc::time_point> > item_ids_requested_from_peer; /// we check this to detect a timed-out request and in busy()
-      fc::time_point last_sync_item_received_time; /// the time we received the last sync item or the time we sent the last batch of sync item requests to this peer
+      fc::time_point last_sync_item_received_time; /// the time we received the last sync item, or the time we sent sync item requests to this peer when none were outstanding
       std::set<item_hash_t> sync_items_requested_from_peer; /// ids of blocks we've requested from this peer during sync.  fetch from another peer if this peer disconnects
+      std::set<item_hash_t> sync_items_reassigned_from_peer; /// sync requests that were handed to another peer after this one stalled, until another peer delivers them.  a late reply to one of these is dropped, not treated as unrequested
+      fc::microseconds sync_item_service_time; /// moving average of how long this peer takes to deliver each sync block we request, zero until measured
       item_hash_t last_block_delegate_has_seen; /// the hash of the last block  this peer has told us about that the peer knows
       fc::time_point_sec last_block_time_delegate_has_seen;
       bool inhibit_fetching_sync_blocks;
@@ -254,6 +257,28 @@ namespace graphene { namespace net
       timestamped_items_set_type inventory_advertised_to_peer;
 
       item_to_time_map_type items_requested_from_peer;  /// items we've requested from this peer during normal operation.  fetch from another peer if this peer disconnects
+
+      bool supports_compact_blocks; /// set from the hello message, the peer can send and receive compact_block_messages
+      struct partial_compact_block
+      {
+        compact_block_message                           compact_block;
+        std::vector<fc::optional<signed_transaction> >  transactions;
+        std::vector<uint32_t>                           missing_transaction_indices;
+      };
+      std::map<item_hash_t, partial_compact_block> partial_compact_blocks; /// compact blocks from this peer waiting for missing transactions, by block message hash
+      /// @}
+
+      /// transfer statistics, used to steer requests toward peers that answer quickly
+      /// @{
+      fc::microseconds item_service_time; /// moving average of how long this peer takes to deliver an item we request during normal operation, zero until measured
+      uint64_t items_received; /// items delivered in answer to our requests during normal operation
+      uint64_t sync_items_received; /// sync blocks delivered in answer to our requests
+      uint32_t item_requests_failed; /// requests during normal operation the peer couldn't answer
+      uint32_t sync_item_requests_failed; /// sync requests the peer couldn't answer, plus one for each stall that made us reassign its requests
+      uint32_t download_rate; /// bytes per second received from this peer, averaged over roughly the last minute
+      uint32_t upload_rate; /// bytes per second sent to this peer, averaged over roughly the last minute
+      uint64_t total_bytes_received_at_last_sample;
+      uint64_t total_bytes_sent_at_last_sample;
       /// @}
 
       // if they're flooding us with transactions, we set this to avoid fetching for a few seconds to let the
@@ -306,6 +331,8 @@ namespace graphene { namespace net
       bool is_currently_handling_message() const;
 
       bool is_transaction_fetching_inhibited() const;
+      /// our best guess at how long this peer takes to answer a request, or zero if we know nothing about it yet
+      fc::microseconds get_expected_service_time(bool during_sync) const;
       fc::sha512 get_shared_secret() const;
       void clear_old_inventory();
       bool is_inventory_advertised_to_us_list_full_for_transactions() const;
@@ -26,6 +26,8 @@
 #include <fc/crypto/aes.hpp>
 #include <fc/crypto/elliptic.hpp>
 
+#include <vector>
+
 namespace graphene { namespace net {
 
 /**
@@ -50,6 +52,13 @@ class stcp_socket : public virtual fc::iostream
     virtual size_t   writesome( const char* buffer, size_t len );
     virtual size_t   writesome( const std::shared_ptr<const char>& buf, size_t len, size_t offset );
 
+    /**
+     *  Encrypts and writes the concatenation of @p parts, zero padded to a multiple of 16 bytes, encrypting
+     *  straight from the parts instead of first copying them into one contiguous buffer.
+     *  @returns the number of bytes written, including the padding
+     */
+    size_t           write_gather( const std::vector<std::pair<const char*, size_t>>& parts );
+
     virtual void     flush();
     virtual void     close();
 
@@ -58,6 +67,8 @@ class stcp_socket : public virtual fc::iostream
     fc::sha512       get_shared_secret() const { return _shared_secret; }
   private:
     void do_key_exchange();
+    void encrypt_to_write_buffer( const char* plaintext, size_t len );
+    void flush_write_buffer();
 
     fc::sha512           _shared_secret;
     fc::ecc::private_key _priv_key;
@@ -66,8 +77,15 @@ class stcp_socket : public virtual fc::iostream
     fc::tcp_socket       _sock;
     fc::aes_encoder      _send_aes;
     fc::aes_decoder      _recv_aes;
+    /// ciphertext read from the socket
     std::shared_ptr<char> _read_buffer;
+    /// plaintext decrypted ahead of the reader, _decrypted_begin to _decrypted_end is still unread
+    std::unique_ptr<char[]> _decrypted_buffer;
+    size_t                _decrypted_begin = 0;
+    size_t                _decrypted_end = 0;
+    /// ciphertext waiting to be written to the socket, up to _write_buffer_used
     std::shared_ptr<char> _write_buffer;
+    size_t                _write_buffer_used = 0;
 #ifndef NDEBUG
     bool _read_buffer_in_use;
     bool _write_buffer_in_use;
@@ -29,6 +29,7 @@
 #include <forward_list>
 #include <iostream>
 #include <algorithm>
+#include <limits>
 #include <tuple>
 #include <boost/tuple/tuple.hpp>
 #include <boost/circular_buffer.hpp>
@@ -176,6 +177,7 @@ namespace graphene { namespace net {
       void cache_message( const message& message_to_cache, const message_hash_type& hash_of_message_to_cache,
                         const message_propagation_data& propagation_data, const fc::uint160_t& message_content_hash );
       message get_message( const message_hash_type& hash_of_message_to_lookup );
+      const message* find_message( const message_hash_type& hash_of_message_to_lookup ) const;
       message_propagation_data get_message_propagation_data( const fc::uint160_t& hash_of_message_contents_to_lookup ) const;
       size_t size() const { return _message_cache.size(); }
     };
@@ -209,6 +211,15 @@ namespace graphene { namespace net {
       FC_THROW_EXCEPTION(  fc::key_not_found_exception, "Requested message not in cache" );
     }
 
+    const message* blockchain_tied_message_cache::find_message( const message_hash_type& hash_of_message_to_lookup ) const
+    {
+      message_cache_container::index<message_hash_index>::type::const_iterator iter =
+         _message_cache.get<message_hash_index>().find(hash_of_message_to_lookup );
+      if( iter != _message_cache.get<message_hash_index>().end() )
+        return &iter->message_body;
+      return nullptr;
+    }
+
     message_propagation_data blockchain_tied_message_cache::get_message_propagation_data( const fc::uint160_t& hash_of_message_contents_to_lookup ) const
     {
       if( hash_of_message_contents_to_lookup != fc::uint160_t() )
@@ -314,7 +325,11 @@ namespace graphene { namespace net { namespace detail {
       _node_is_shutting_down(false),
       _maximum_number_of_blocks_to_handle_at_one_time(MAXIMUM_NUMBER_OF_BLOCKS_TO_HANDLE_AT_ONE_TIME),
       _maximum_number_of_sync_blocks_to_prefetch(MAXIMUM_NUMBER_OF_BLOCKS_TO_PREFETCH),
-      _maximum_blocks_per_peer_during_syncing(GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING)
+      _maximum_blocks_per_peer_during_syncing(GRAPHENE_NET_MAX_BLOCKS_PER_PEER_DURING_SYNCING),
+      _compact_block_relay_enabled(true),
+      _parallel_sync_enabled(false),
+      _sync_reorder_window(MAXIMUM_NUMBER_OF_BLOCKS_TO_PREFETCH),
+      _min_sync_item_request_timeout(fc::milliseconds(GRAPHENE_NET_MIN_SYNC_ITEM_REQUEST_TIMEOUT_MS))
     {
       _rate_limiter.set_actual_rate_time_constant(fc::seconds(2));
       fc::rand_pseudo_bytes(&_node_id.data[0], (int)_node_id.size());
@@ -480,10 +495,7 @@ namespace graphene { namespace net { namespace detail {
     bool node_impl::have_already_received_sync_item( const item_hash_t& item_hash )
     {
       VERIFY_CORRECT_THREAD();
-      return std::find_if(_received_sync_items.begin(), _received_sync_items.end(),
-                          [&item_hash]( const graphene::net::block_message& message ) { return message.block_id == item_hash; } ) != _received_sync_items.end() ||
-             std::find_if(_new_received_sync_items.begin(), _new_received_sync_items.end(),
-                          [&item_hash]( const graphene::net::block_message& message ) { return message.block_id == item_hash; } ) != _new_received_sync_items.end();                          ;
+      return _received_sync_items.get<block_id_index>().find(item_hash) != _received_sync_items.get<block_id_index>().end();
     }
 
     void node_impl::request_sync_item_from_peer( const peer_connection_ptr& peer, const item_hash_t& item_to_request )
@@ -492,7 +504,9 @@ namespace graphene { namespace net { namespace detail {
       dlog( "requesting item ${item_hash} from peer ${endpoint}", ("item_hash", item_to_request )("endpoint", peer->get_remote_endpoint() ) );
       item_id item_id_to_request( graphene::net::block_message_type, item_to_request );
       _active_sync_requests.insert( active_sync_requests_map::value_type(item_to_request, fc::time_point::now() ) );
-      peer->last_sync_item_received_time = fc::time_point::now();
+      // with requests already outstanding, the clock keeps running from the last delivery
+      if( peer->sync_items_requested_from_peer.empty() )
+        peer->last_sync_item_received_time = fc::time_point::now();
       peer->sync_items_requested_from_peer.insert(item_to_request);
       peer->send_message( fetch_items_message(item_id_to_request.item_type, std::vector<item_hash_t>{item_id_to_request.item_hash} ) );
     }
@@ -502,15 +516,131 @@ namespace graphene { namespace net { namespace detail {
       VERIFY_CORRECT_THREAD();
       dlog( "requesting ${item_count} item(s) ${items_to_request} from peer ${endpoint}",
             ("item_count", items_to_request.size())("items_to_request", items_to_request)("endpoint", peer->get_remote_endpoint()) );
+      // pipelined batches don't restart the clock, it runs from the last delivery while requests are
+      // outstanding, so both the service time and the no-progress disconnect see the peer's real pace
+      if (peer->sync_items_requested_from_peer.empty())
+        peer->last_sync_item_received_time = fc::time_point::now();
       for (const item_hash_t& item_to_request : items_to_request)
       {
         _active_sync_requests.insert( active_sync_requests_map::value_type(item_to_request, fc::time_point::now() ) );
-        peer->last_sync_item_received_time = fc::time_point::now();
         peer->sync_items_requested_from_peer.insert(item_to_request);
       }
       peer->send_message(fetch_items_message(graphene::net::block_message_type, items_to_request));
     }
 
+    void node_impl::reassign_timed_out_sync_item_requests()
+    {
+      VERIFY_CORRECT_THREAD();
+      fc::time_point now = fc::time_point::now();
+      std::vector<peer_connection_ptr> peers_needing_item_ids;
+      for( const peer_connection_ptr& peer : _active_connections )
+      {
+        if( peer->sync_items_requested_from_peer.empty() )
+          continue;
+        // a peer answers its requests in order, so a deep pipeline is only late if the peer stops delivering.
+        // last_sync_item_received_time is the last delivery, or the request if none were outstanding, so
+        // measure from there instead of from each item's own request time
+        fc::microseconds timeout = std::max( _min_sync_item_request_timeout, fc::microseconds( peer->sync_item_service_time.count() * 4 ) );
+        if( peer->last_sync_item_received_time >= now - timeout )
+          continue;
+        // the peer has stalled: everything still queued with it is stuck behind the missing block
+        dlog( "peer ${endpoint} delivered no sync block in ${timeout} us, reassigning its ${count} outstanding requests",
+              ("endpoint", peer->get_remote_endpoint())("timeout", timeout.count())("count", peer->sync_items_requested_from_peer.size()) );
+        for( const item_hash_t& item_hash : peer->sync_items_requested_from_peer )
+        {
+          _active_sync_requests.erase( item_hash );
+          peer->sync_items_reassigned_from_peer.insert( item_hash );
+        }
+        peer->sync_items_requested_from_peer.clear();
+        // one stall, however many requests were queued behind it; treat the peer as slow until it proves otherwise
+        ++peer->sync_item_requests_failed;
+        peer->sync_item_service_time = std::max( fc::microseconds( peer->sync_item_service_time.count() * 2 ), timeout );
+        if( peer->idle() &&
+            peer->number_of_unfetched_item_ids > 0 &&
+            peer->ids_of_items_to_get.size() < GRAPHENE_NET_MIN_BLOCK_IDS_TO_PREFETCH )
+          peers_needing_item_ids.push_back( peer );
+      }
+      for( const peer_connection_ptr& peer : peers_needing_item_ids )
+        fetch_next_batch_of_item_ids_from_peer( peer.get() );
+    }
+
+    void node_impl::schedule_parallel_sync_item_requests( std::map<peer_connection_ptr, std::vector<item_hash_t> >& sync_item_requests_to_send )
+    {
+      VERIFY_CORRECT_THREAD();
+      ASSERT_TASK_NOT_PREEMPTED();
+
+      // blocks are applied strictly in order, so only fetch within a window past the oldest block still needed;
+      // anything further ahead would just sit in the reorder buffer while the gap is filled
+      uint32_t window_start = std::numeric_limits<uint32_t>::max();
+      fc::microseconds fastest_service_time = fc::microseconds::maximum();
+      std::vector<peer_connection_ptr> syncing_peers;
+      for( const peer_connection_ptr& peer : _active_connections )
+      {
+        if( !peer->we_need_sync_items_from_peer || peer->inhibit_fetching_sync_blocks )
+          continue;
+        // let a peer that is running low on block ids go idle so we can ask it for the next batch
+        if( !peer->sync_items_requested_from_peer.empty() &&
+            peer->number_of_unfetched_item_ids > 0 &&
+            peer->ids_of_items_to_get.size() < GRAPHENE_NET_MIN_BLOCK_IDS_TO_PREFETCH )
+          continue;
+        if( peer->item_ids_requested_from_peer )
+          continue;
+        syncing_peers.push_back( peer );
+        if( !peer->ids_of_items_to_get.empty() )
+          window_start = std::min( window_start, graphene::chain::block_header::num_from_id( peer->ids_of_items_to_get.front() ) );
+        if( peer->sync_item_service_time > fc::microseconds() )
+          fastest_service_time = std::min( fastest_service_time, peer->sync_item_service_time );
+      }
+      if( window_start == std::numeric_limits<uint32_t>::max() )
+        return;
+      uint64_t window_end = uint64_t( window_start ) + _sync_reorder_window;
+
+      // collect the items within the window, in block order, along with the peers able to provide each one
+      std::map<std::pair<uint32_t, item_hash_t>, std::vector<peer_connection_ptr> > items_to_request;
+      for( const peer_connection_ptr& peer : syncing_peers )
+        for( const item_hash_t& item_to_potentially_request : peer->ids_of_items_to_get )
+        {
+          uint32_t block_number = graphene::chain::block_header::num_from_id( item_to_potentially_request );
+          if( block_number >= window_end )
+            break;
+          if( !have_already_received_sync_item( item_to_potentially_request ) &&
+              _active_sync_requests.find( item_to_potentially_request ) == _active_sync_requests.end() )
+            items_to_request[std::make_pair( block_number, item_to_potentially_request )].push_back( peer );
+        }
+
+      // a peer may have as many requests in flight as its share of throughput allows: the fastest peer gets
+      // the full per-peer allowance, slower ones proportionally less.  peers we haven't measured yet get the full allowance
+      auto allowance_for_peer = [&]( const peer_connection_ptr& peer ) -> uint32_t {
+        if( peer->sync_item_service_time <= fc::microseconds() || fastest_service_time == fc::microseconds::maximum() )
+          return _maximum_blocks_per_peer_during_syncing;
+        uint64_t allowance = uint64_t( _maximum_blocks_per_peer_during_syncing ) * fastest_service_time.count() / peer->sync_item_service_time.count();
+        return std::max<uint32_t>( 1, uint32_t( allowance ) );
+      };
+
+      for( const auto& item_and_peers : items_to_request )
+      {
+        peer_connection_ptr least_loaded_peer;
+        double lowest_load = std::numeric_limits<double>::max();
+        for( const peer_connection_ptr& peer : item_and_peers.second )
+        {
+          auto scheduled_iter = sync_item_requests_to_send.find( peer );
+          size_t outstanding = peer->sync_items_requested_from_peer.size() +
+                               ( scheduled_iter == sync_item_requests_to_send.end() ? 0 : scheduled_iter->second.size() );
+          uint32_t allowance = allowance_for_peer( peer );
+          if( outstanding >= allowance )
+            continue;
+          double load = double( outstanding ) / allowance;
+          if( load < lowest_load )
+          {
+            lowest_load = load;
+            least_loaded_peer = peer;
+          }
+        }
+        if( least_loaded_peer )
+          sync_item_requests_to_send[least_loaded_peer].push_back( item_and_peers.first.second );
+      }
+    }
+
     void node_impl::fetch_sync_items_loop()
     {
       VERIFY_CORRECT_THREAD();
@@ -523,12 +653,31 @@ namespace graphene { namespace net { namespace detail {
         {
           std::map<peer_connection_ptr, std::vector<item_hash_t> > sync_item_requests_to_send;
 
+          if (_parallel_sync_enabled)
+          {
+            reassign_timed_out_sync_item_requests();
+            schedule_parallel_sync_item_requests(sync_item_requests_to_send);
+          }
+          else
           {
             ASSERT_TASK_NOT_PREEMPTED();
             std::set<item_hash_t> sync_items_to_request;
 
+            // peers are offered the blocks we need first in order of how quickly they have been delivering
+            // blocks, so a slow link doesn't hold up the next block to apply.  peers we haven't measured
+            // yet come last and pick up what is left
+            std::vector<peer_connection_ptr> peers_by_service_time(_active_connections.begin(), _active_connections.end());
+            std::stable_sort(peers_by_service_time.begin(), peers_by_service_time.end(),
+                             [](const peer_connection_ptr& lhs, const peer_connection_ptr& rhs) {
+                               fc::microseconds lhs_time = lhs->get_expected_service_time(true);
+                               fc::microseconds rhs_time = rhs->get_expected_service_time(true);
+                               if (lhs_time <= fc::microseconds() || rhs_time <= fc::microseconds())
+                                 return lhs_time > rhs_time;
+                               return lhs_time < rhs_time;
+                             });
+
             // for each idle peer that we're syncing with
-            for( const peer_connection_ptr& peer : _active_connections )
+            for( const peer_connection_ptr& peer : peers_by_service_time )
             {
               if( peer->we_need_sync_items_from_peer &&
                   sync_item_requests_to_send.find(peer) == sync_item_requests_to_send.end() && // if we've already scheduled a request for this peer, don't consider scheduling another
@@ -569,7 +718,17 @@ namespace graphene { namespace net { namespace detail {
         {
           dlog( "no sync items to fetch right now, going to sleep" );
           _retrigger_fetch_sync_items_loop_promise = fc::promise<void>::ptr( new fc::promise<void>("graphene::net::retrigger_fetch_sync_items_loop") );
-          _retrigger_fetch_sync_items_loop_promise->wait();
+          try
+          {
+            // in parallel sync, wake up periodically to reassign requests that have timed out
+            if (_parallel_sync_enabled && !_active_sync_requests.empty())
+              _retrigger_fetch_sync_items_loop_promise->wait(_min_sync_item_request_timeout);
+            else
+              _retrigger_fetch_sync_items_loop_promise->wait();
+          }
+          catch (const fc::timeout_exception&) //intentionally not logged
+          {
+          }
           _retrigger_fetch_sync_items_loop_promise.reset();
         }
       } // while( !canceled )
@@ -584,6 +743,17 @@ namespace graphene { namespace net { namespace detail {
         _retrigger_fetch_sync_items_loop_promise->set_value();
     }
 
+    void node_impl::record_item_received( peer_connection* peer, const fc::time_point& request_time )
+    {
+      VERIFY_CORRECT_THREAD();
+      fc::microseconds service_time = fc::time_point::now() - request_time;
+      if (peer->item_service_time <= fc::microseconds())
+        peer->item_service_time = service_time;
+      else
+        peer->item_service_time = fc::microseconds((peer->item_service_time.count() * 7 + service_time.count()) / 8);
+      ++peer->items_received;
+    }
+
     bool node_impl::is_item_in_any_peers_inventory(const item_id& item) const
     {
       for( const peer_connection_ptr& peer : _active_connections )
@@ -616,12 +786,18 @@ namespace graphene { namespace net { namespace detail {
           std::vector<item_id> item_ids;
           peer_and_items_to_fetch(const peer_connection_ptr& peer) : peer(peer) {}
           bool operator<(const peer_and_items_to_fetch& rhs) const { return peer < rhs.peer; }
-          size_t number_of_items() const { return item_ids.size(); }
+          // how long we expect the peer to take to deliver everything we've assigned it plus one more item, so
+          // each item goes to the peer likely to deliver it first rather than the one with the fewest requests.
+          // peers we know nothing about yet are treated as fast so they get a chance to be measured
+          double expected_completion_time() const
+          {
+            return double(item_ids.size() + 1) * std::max<int64_t>(peer->get_expected_service_time(false).count(), 1);
+          }
         };
         typedef boost::multi_index_container<peer_and_items_to_fetch,
                                              boost::multi_index::indexed_by<boost::multi_index::ordered_unique<boost::multi_index::member<peer_and_items_to_fetch, peer_connection_ptr, &peer_and_items_to_fetch::peer> >,
                                                                             boost::multi_index::ordered_non_unique<boost::multi_index::tag<requested_item_count_index>,
-                                                                                                                   boost::multi_index::const_mem_fun<peer_and_items_to_fetch, size_t, &peer_and_items_to_fetch::number_of_items> > > > fetch_messages_to_send_set;
+                                                                                                                   boost::multi_index::const_mem_fun<peer_and_items_to_fetch, double, &peer_and_items_to_fetch::expected_completion_time> > > > fetch_messages_to_send_set;
         fetch_messages_to_send_set items_by_peer;
 
         // initialize the fetch_messages_to_send with an empty set of items for all idle peers
@@ -642,7 +818,7 @@ namespace graphene { namespace net { namespace detail {
           }
           else
           {
-            // find a peer that has it, we'll use the one who has the least requests going to it to load balance
+            // find a peer that has it, we'll use the one expected to deliver it soonest to load balance
             bool item_fetched = false;
             for (auto peer_iter = items_by_peer.get<requested_item_count_index>().begin(); peer_iter != items_by_peer.get<requested_item_count_index>().end(); ++peer_iter)
             {
@@ -687,7 +863,13 @@ namespace graphene { namespace net { namespace detail {
                  ("count", items_by_type.second.size())("type", (uint32_t)items_by_type.first)
                  ("endpoint", peer_and_items.peer->get_remote_endpoint())
                  ("hashes", items_by_type.second));
-            peer_and_items.peer->send_message(fetch_items_message(items_by_type.first,
+            // blocks are still tracked as block_message_type items in items_requested_from_peer,
+            // only the form in which the peer sends them changes
+            uint32_t item_type_to_request = items_by_type.first;
+            if (item_type_to_request == block_message_type &&
+                _compact_block_relay_enabled && peer_and_items.peer->supports_compact_blocks)
+              item_type_to_request = compact_block_message_type;
+            peer_and_items.peer->send_message(fetch_items_message(item_type_to_request,
                                                                   items_by_type.second));
           }
         }
@@ -865,6 +1047,7 @@ namespace graphene { namespace net { namespace detail {
         fc::time_point active_disconnect_threshold = fc::time_point::now() - fc::seconds(active_disconnect_timeout);
         fc::time_point active_send_keepalive_threshold = fc::time_point::now() - fc::seconds(active_send_keepalive_timeout);
         fc::time_point active_ignored_request_threshold = fc::time_point::now() - active_ignored_request_timeout;
+        fc::time_point round_trip_probe_threshold = fc::time_point::now() - fc::seconds(GRAPHENE_NET_PEER_ROUND_TRIP_PROBE_INTERVAL);
         for( const peer_connection_ptr& active_peer : _active_connections )
         {
           if( active_peer->connection_initiation_time < active_disconnect_threshold &&
@@ -929,6 +1112,11 @@ namespace graphene { namespace net { namespace detail {
                       ("peer", active_peer->get_remote_endpoint()));
               peers_to_disconnect_forcibly.push_back(active_peer);
             }
+            else if (active_peer->last_round_trip_probe_time < round_trip_probe_threshold)
+            {
+              // not a keepalive, but the reply refreshes our measurement of the peer's latency
+              peers_to_send_keep_alive.push_back(active_peer);
+            }
           }
         }
 
@@ -991,8 +1179,11 @@ namespace graphene { namespace net { namespace detail {
       peers_to_disconnect_gently.clear();
 
       for( const peer_connection_ptr& peer : peers_to_send_keep_alive )
+      {
+        peer->last_round_trip_probe_time = fc::time_point::now();
         peer->send_message(current_time_request_message(),
                            offsetof(current_time_request_message, request_sent_time));
+      }
       peers_to_send_keep_alive.clear();
 
       if (!_node_is_shutting_down && !_terminate_inactive_connections_loop_done.canceled())
@@ -1059,6 +1250,24 @@ namespace graphene { namespace net { namespace detail {
         }
       }
     }
+    void node_impl::update_peer_transfer_rates(uint32_t seconds_since_last_update)
+    {
+      VERIFY_CORRECT_THREAD();
+      for (const peer_connection_ptr& peer : _active_connections)
+      {
+        ASSERT_TASK_NOT_PREEMPTED(); // don't yield while iterating over _active_connections
+        uint64_t total_bytes_received = peer->get_total_bytes_received();
+        uint64_t total_bytes_sent = peer->get_total_bytes_sent();
+        uint32_t read_rate = (uint32_t)((total_bytes_received - peer->total_bytes_received_at_last_sample) / seconds_since_last_update);
+        uint32_t write_rate = (uint32_t)((total_bytes_sent - peer->total_bytes_sent_at_last_sample) / seconds_since_last_update);
+        // exponential moving average with a time constant of about a minute
+        peer->download_rate = (uint32_t)((uint64_t(peer->download_rate) * 59 + read_rate) / 60);
+        peer->upload_rate = (uint32_t)((uint64_t(peer->upload_rate) * 59 + write_rate) / 60);
+        peer->total_bytes_received_at_last_sample = total_bytes_received;
+        peer->total_bytes_sent_at_last_sample = total_bytes_sent;
+      }
+    }
+
     void node_impl::bandwidth_monitor_loop()
     {
       VERIFY_CORRECT_THREAD();
@@ -1074,6 +1283,7 @@ namespace graphene { namespace net { namespace detail {
       for (uint32_t i = 0; i < seconds_since_last_update - 1; ++i)
         update_bandwidth_data(0, 0);
       update_bandwidth_data(bytes_read_this_second, bytes_written_this_second);
+      update_peer_transfer_rates(seconds_since_last_update);
       _bandwidth_monitor_last_update_time = current_time;
 
       if (!_node_is_shutting_down && !_bandwidth_monitor_loop_done.canceled())
@@ -1296,6 +1506,15 @@ namespace graphene { namespace net { namespace detail {
       case core_message_type_enum::block_message_type:
         process_block_message(originating_peer, received_message, message_hash);
         break;
+      case core_message_type_enum::compact_block_message_type:
+        on_compact_block_message(originating_peer, received_message.as<compact_block_message>());
+        break;
+      case core_message_type_enum::fetch_compact_block_transactions_message_type:
+        on_fetch_compact_block_transactions_message(originating_peer, received_message.as<fetch_compact_block_transactions_message>());
+        break;
+      case core_message_type_enum::compact_block_transactions_message_type:
+        on_compact_block_transactions_message(originating_peer, received_message.as<compact_block_transactions_message>());
+        break;
       case core_message_type_enum::current_time_request_message_type:
         on_current_time_request_message(originating_peer, received_message.as<current_time_request_message>());
         break;
@@ -1357,6 +1576,9 @@ namespace graphene { namespace net { namespace detail {
       if (!_hard_fork_block_numbers.empty())
         user_data["last_known_fork_block_number"] = _hard_fork_block_numbers.back();
 
+      if (_compact_block_relay_enabled)
+        user_data["compact_block_relay"] = true;
+
       return user_data;
     }
     void node_impl::parse_hello_user_data_for_peer(peer_connection* originating_peer, const fc::variant_object& user_data)
@@ -1379,6 +1601,8 @@ namespace graphene { namespace net { namespace detail {
         originating_peer->node_id = user_data["node_id"].as<node_id_t>(1);
       if (user_data.contains("last_known_fork_block_number"))
         originating_peer->last_known_fork_block_number = user_data["last_known_fork_block_number"].as<uint32_t>(1);
+      if (user_data.contains("compact_block_relay"))
+        originating_peer->supports_compact_blocks = user_data["compact_block_relay"].as_bool();
     }
 
     void node_impl::on_hello_message( peer_connection* originating_peer, const hello_message& hello_message_received )
@@ -2246,6 +2470,22 @@ namespace graphene { namespace net { namespace detail {
       return item_not_available_message(item);
     }
 
+    fc::optional<message> node_impl::find_block_message(const item_hash_t& block_message_hash)
+    {
+      const message* cached_message = _message_cache.find_message(block_message_hash);
+      if (cached_message && cached_message->msg_type == block_message_type)
+        return *cached_message;
+      try
+      {
+        message block_msg = _delegate->get_item(item_id(block_message_type, block_message_hash));
+        if (block_msg.msg_type == block_message_type)
+          return block_msg;
+      }
+      catch (fc::key_not_found_exception&)
+      {}
+      return fc::optional<message>();
+    }
+
     void node_impl::on_fetch_items_message(peer_connection* originating_peer, const fetch_items_message& fetch_items_message_received)
     {
       VERIFY_CORRECT_THREAD();
@@ -2256,6 +2496,36 @@ namespace graphene { namespace net { namespace detail {
 
       fc::optional<message> last_block_message_sent;
 
+      if (fetch_items_message_received.item_type == compact_block_message_type)
+      {
+        // compact blocks are built from the block in our message cache or, like full blocks, from the
+        // delegate's copy of it, only blocks we don't have at all make the peer fall back to the full block
+        std::list<message> compact_block_replies;
+        for (const item_hash_t& item_hash : fetch_items_message_received.items_to_fetch)
+        {
+          fc::optional<message> block_msg = find_block_message(item_hash);
+          if (!block_msg)
+          {
+            compact_block_replies.push_back(item_not_available_message(item_id(block_message_type, item_hash)));
+            continue;
+          }
+          graphene::net::block_message block = block_msg->as<graphene::net::block_message>();
+          compact_block_message compact_block;
+          compact_block.block_message_hash = item_hash;
+          compact_block.header = block.block;
+          compact_block.transactions.reserve(block.block.transactions.size());
+          for (const graphene::chain::processed_transaction& transaction : block.block.transactions)
+            compact_block.transactions.push_back(compact_block_transaction{message(trx_message(transaction)).id(),
+                                                                           transaction.operation_results});
+          compact_block_replies.push_back(compact_block);
+          originating_peer->last_block_delegate_has_seen = block.block_id;
+          originating_peer->last_block_time_delegate_has_seen = block.block.timestamp;
+        }
+        for (const message& reply : compact_block_replies)
+          originating_peer->send_message(reply);
+        return;
+      }
+
       std::list<message> reply_messages;
       for (const item_hash_t& item_hash : fetch_items_message_received.items_to_fetch)
       {
@@ -2322,6 +2592,7 @@ namespace graphene { namespace net { namespace detail {
       {
         originating_peer->items_requested_from_peer.erase( regular_item_iter );
         originating_peer->inventory_peer_advertised_to_us.erase( requested_item );
+        ++originating_peer->item_requests_failed;
         if (is_item_in_any_peers_inventory(requested_item))
           _items_to_fetch.insert(prioritized_item_id(requested_item, _items_to_fetch_sequence_counter++));
         wlog("Peer doesn't have the requested item.");
@@ -2333,6 +2604,7 @@ namespace graphene { namespace net { namespace detail {
       if (sync_item_iter != originating_peer->sync_items_requested_from_peer.end())
       {
         originating_peer->sync_items_requested_from_peer.erase(sync_item_iter);
+        ++originating_peer->sync_item_requests_failed;
 
         if (originating_peer->peer_needs_sync_items_from_us)
           originating_peer->inhibit_fetching_sync_blocks = true;
@@ -2750,34 +3022,40 @@ namespace graphene { namespace net { namespace detail {
 
       do
       {
-        std::copy(std::make_move_iterator(_new_received_sync_items.begin()),
-                  std::make_move_iterator(_new_received_sync_items.end()),
-                  std::front_inserter(_received_sync_items));
-        _new_received_sync_items.clear();
         dlog("currently ${count} sync items to consider", ("count", _received_sync_items.size()));
 
         block_processed_this_iteration = false;
-        for (auto received_block_iter = _received_sync_items.begin();
-             received_block_iter != _received_sync_items.end();
-             ++received_block_iter)
+
+        // a block can only be processed once it is the next block some peer is syncing us to, so only the
+        // blocks at the front of the peers' lists need to be looked up, lowest block number first
+        auto& received_by_id = _received_sync_items.get<block_id_index>();
+        auto received_block_iter = received_by_id.end();
+        for (const peer_connection_ptr& peer : _active_connections)
         {
+          ASSERT_TASK_NOT_PREEMPTED(); // don't yield while iterating over _active_connections
+          if (peer->ids_of_items_to_get.empty())
+            continue;
+          auto candidate = received_by_id.find(peer->ids_of_items_to_get.front());
+          if (candidate != received_by_id.end() &&
+              (received_block_iter == received_by_id.end() || candidate->block_num < received_block_iter->block_num))
+            received_block_iter = candidate;
+        }
 
+        if (received_block_iter != received_by_id.end())
+        {
           // find out if this block is the next block on the active chain or one of the forks
-          bool potential_first_block = false;
           for (const peer_connection_ptr& peer : _active_connections)
           {
             ASSERT_TASK_NOT_PREEMPTED(); // don't yield while iterating over _active_connections
             if (!peer->ids_of_items_to_get.empty() &&
-                peer->ids_of_items_to_get.front() == received_block_iter->block_id)
+                peer->ids_of_items_to_get.front() == received_block_iter->block_id())
             {
-              potential_first_block = true;
               peer->ids_of_items_to_get.pop_front();
-              peer->ids_of_items_being_processed.insert(received_block_iter->block_id);
+              peer->ids_of_items_being_processed.insert(received_block_iter->block_id());
             }
           }
 
-          // if it is, process it, remove it from all sync peers lists
-          if (potential_first_block)
+          // it is, process it, remove it from all sync peers lists
           {
             // we can get into an interesting situation near the end of synchronization.  We can be in
             // sync with one peer who is sending us the last block on the chain via a regular inventory
@@ -2786,10 +3064,10 @@ namespace graphene { namespace net { namespace detail {
             // we don't know they're the same (for the peer in normal operation, it has only told us the
             // message id, for the peer in the sync case we only known the block_id).
             if (std::find(_most_recent_blocks_accepted.begin(), _most_recent_blocks_accepted.end(),
-                          received_block_iter->block_id) == _most_recent_blocks_accepted.end())
+                          received_block_iter->block_id()) == _most_recent_blocks_accepted.end())
             {
-              graphene::net::block_message block_message_to_process = *received_block_iter;
-              _received_sync_items.erase(received_block_iter);
+              graphene::net::block_message block_message_to_process = received_block_iter->message;
+              received_by_id.erase(received_block_iter);
               _handle_message_calls_in_progress.emplace_back(fc::async([this, block_message_to_process](){
                 send_sync_block_to_node_delegate(block_message_to_process);
               }, "send_sync_block_to_node_delegate"));
@@ -2799,10 +3077,13 @@ namespace graphene { namespace net { namespace detail {
             else
             {
               dlog("Already received and accepted this block (presumably through normal inventory mechanism), treating it as accepted");
+              // no peer will list it again, so it would only be skipped over by every later drain
+              const item_hash_t accepted_block_id = received_block_iter->block_id();
+              received_by_id.erase(received_block_iter);
               std::vector< peer_connection_ptr > peers_needing_next_batch;
               for (const peer_connection_ptr& peer : _active_connections)
               {
-                auto items_being_processed_iter = peer->ids_of_items_being_processed.find(received_block_iter->block_id);
+                auto items_being_processed_iter = peer->ids_of_items_being_processed.find(accepted_block_id);
                 if (items_being_processed_iter != peer->ids_of_items_being_processed.end())
                 {
                   peer->ids_of_items_being_processed.erase(items_being_processed_iter);
@@ -2824,10 +3105,8 @@ namespace graphene { namespace net { namespace detail {
               for( const peer_connection_ptr& peer : peers_needing_next_batch )
                 fetch_next_batch_of_item_ids_from_peer(peer.get());
             }
-
-            break; // start iterating _received_sync_items from the beginning
-          } // end if potential_first_block
-        } // end for each block in _received_sync_items
+          }
+        } // end if a received block is the next one for some peer
 
         if (_handle_message_calls_in_progress.size() >= _maximum_number_of_blocks_to_handle_at_one_time)
         {
@@ -2860,9 +3139,9 @@ namespace graphene { namespace net { namespace detail {
       VERIFY_CORRECT_THREAD();
       dlog( "received a sync block from peer ${endpoint}", ("endpoint", originating_peer->get_remote_endpoint() ) );
 
-      // add it to the front of _received_sync_items, then process _received_sync_items to try to
+      // add it to _received_sync_items, then process _received_sync_items to try to
       // pass as many messages as possible to the client.
-      _new_received_sync_items.push_front( block_message_to_process );
+      _received_sync_items.insert( received_sync_block( block_message_to_process ) );
       trigger_process_backlog_of_sync_blocks();
     }
 
@@ -3025,6 +3304,7 @@ namespace graphene { namespace net { namespace detail {
       auto item_iter = originating_peer->items_requested_from_peer.find(item_id(graphene::net::block_message_type, message_hash));
       if (item_iter != originating_peer->items_requested_from_peer.end())
       {
+        record_item_received(originating_peer, item_iter->second);
         originating_peer->items_requested_from_peer.erase(item_iter);
         process_block_during_normal_operation(originating_peer, block_message_to_process, message_hash);
         if (originating_peer->idle())
@@ -3043,8 +3323,21 @@ namespace graphene { namespace net { namespace detail {
           // of the function so we can log if this ever happens.
           try
           {
-            originating_peer->last_sync_item_received_time = fc::time_point::now();
+            fc::time_point now = fc::time_point::now();
+            // last_sync_item_received_time is the later of the previous delivery and the request, so this
+            // measures the time the peer spent on this one block
+            fc::microseconds service_time = now - originating_peer->last_sync_item_received_time;
+            if (originating_peer->sync_item_service_time <= fc::microseconds())
+              originating_peer->sync_item_service_time = service_time;
+            else
+              originating_peer->sync_item_service_time = fc::microseconds((originating_peer->sync_item_service_time.count() * 7 + service_time.count()) / 8);
+            originating_peer->last_sync_item_received_time = now;
+            ++originating_peer->sync_items_received;
             _active_sync_requests.erase(block_message_to_process.block_id);
+            // peers this block was reassigned from no longer need to be forgiven for it
+            for (const peer_connection_ptr& peer : _active_connections)
+              if (peer.get() != originating_peer)
+                peer->sync_items_reassigned_from_peer.erase(block_message_to_process.block_id);
             process_block_during_sync(originating_peer, block_message_to_process, message_hash);
             if (originating_peer->idle())
             {
@@ -3077,6 +3370,27 @@ namespace graphene { namespace net { namespace detail {
             elog("Caught unexpected exception, could break sync operation");
           }
         }
+        else if (originating_peer->sync_items_reassigned_from_peer.erase(block_message_to_process.block_id))
+        {
+          // we gave up waiting for this one and asked another peer for it; not the peer's fault
+          dlog("received sync block ${block_id} from peer ${endpoint} after reassigning it, ignoring",
+               ("block_id", block_message_to_process.block_id)("endpoint", originating_peer->get_remote_endpoint()));
+          originating_peer->last_sync_item_received_time = fc::time_point::now();
+          if (originating_peer->idle())
+            trigger_fetch_sync_items_loop();
+          return;
+        }
+        else if (originating_peer->sync_item_requests_failed > 0 &&
+                 (have_already_received_sync_item(block_message_to_process.block_id) ||
+                  _delegate->has_item(item_id(graphene::net::block_message_type, block_message_to_process.block_id))))
+        {
+          // a late reply to a reassigned request that another peer has answered meanwhile
+          dlog("received sync block ${block_id} from peer ${endpoint} after getting it elsewhere, ignoring",
+               ("block_id", block_message_to_process.block_id)("endpoint", originating_peer->get_remote_endpoint()));
+          if (originating_peer->idle())
+            trigger_fetch_sync_items_loop();
+          return;
+        }
       }
 
       // if we get here, we didn't request the message, we must have a misbehaving peer
@@ -3092,6 +3406,143 @@ namespace graphene { namespace net { namespace detail {
       disconnect_from_peer(originating_peer, "You sent me a block that I didn't ask for", true, detailed_error);
     }
 
+    void node_impl::on_compact_block_message(peer_connection* originating_peer,
+                                             const compact_block_message& compact_block_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      const item_hash_t& block_message_hash = compact_block_message_received.block_message_hash;
+      if (originating_peer->items_requested_from_peer.find(item_id(block_message_type, block_message_hash)) ==
+          originating_peer->items_requested_from_peer.end())
+      {
+        wlog("received a compact block ${hash} I didn't ask for from peer ${endpoint}, disconnecting from peer",
+             ("endpoint", originating_peer->get_remote_endpoint())
+             ("hash", block_message_hash));
+        fc::exception detailed_error(FC_LOG_MESSAGE(error, "You sent me a compact block that I didn't ask for, hash: ${hash}",
+                                                    ("hash", block_message_hash)));
+        disconnect_from_peer(originating_peer, "You sent me a block that I didn't ask for", true, detailed_error);
+        return;
+      }
+
+      // rebuild the block from the transactions we already have in our message cache
+      std::vector<fc::optional<signed_transaction> > transactions(compact_block_message_received.transactions.size());
+      std::vector<uint32_t> missing_transaction_indices;
+      for (uint32_t i = 0; i < compact_block_message_received.transactions.size(); ++i)
+      {
+        const message* cached_message = _message_cache.find_message(compact_block_message_received.transactions[i].transaction_message_hash);
+        if (cached_message && cached_message->msg_type == trx_message_type)
+          transactions[i] = cached_message->as<trx_message>().trx;
+        else
+          missing_transaction_indices.push_back(i);
+      }
+
+      if (missing_transaction_indices.empty())
+      {
+        finish_compact_block(originating_peer, compact_block_message_received, std::move(transactions));
+        return;
+      }
+
+      dlog("missing ${count} of ${total} transactions of compact block ${hash}, requesting them from peer ${endpoint}",
+           ("count", missing_transaction_indices.size())("total", transactions.size())
+           ("hash", block_message_hash)("endpoint", originating_peer->get_remote_endpoint()));
+      originating_peer->send_message(fetch_compact_block_transactions_message(block_message_hash, missing_transaction_indices));
+      peer_connection::partial_compact_block& partial_block = originating_peer->partial_compact_blocks[block_message_hash];
+      partial_block.compact_block = compact_block_message_received;
+      partial_block.transactions = std::move(transactions);
+      partial_block.missing_transaction_indices = std::move(missing_transaction_indices);
+    }
+
+    void node_impl::on_fetch_compact_block_transactions_message(peer_connection* originating_peer,
+                                                                const fetch_compact_block_transactions_message& fetch_compact_block_transactions_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      const item_hash_t& block_message_hash = fetch_compact_block_transactions_message_received.block_message_hash;
+      fc::optional<message> block_msg = find_block_message(block_message_hash);
+      if (!block_msg)
+      {
+        originating_peer->send_message(item_not_available_message(item_id(block_message_type, block_message_hash)));
+        return;
+      }
+
+      graphene::net::block_message block = block_msg->as<graphene::net::block_message>();
+      compact_block_transactions_message reply;
+      reply.block_message_hash = block_message_hash;
+      for (uint32_t index : fetch_compact_block_transactions_message_received.transaction_indices)
+      {
+        if (index >= block.block.transactions.size())
+        {
+          disconnect_from_peer(originating_peer, "You requested a transaction that is not in the block", true,
+                               fc::exception(FC_LOG_MESSAGE(error, "Transaction index ${index} out of range",
+                                                            ("index", index)("hash", block_message_hash))));
+          return;
+        }
+        reply.transactions.push_back(block.block.transactions[index]);
+      }
+      originating_peer->send_message(reply);
+    }
+
+    void node_impl::on_compact_block_transactions_message(peer_connection* originating_peer,
+                                                          const compact_block_transactions_message& compact_block_transactions_message_received)
+    {
+      VERIFY_CORRECT_THREAD();
+      const item_hash_t& block_message_hash = compact_block_transactions_message_received.block_message_hash;
+      auto partial_block_iter = originating_peer->partial_compact_blocks.find(block_message_hash);
+      if (partial_block_iter == originating_peer->partial_compact_blocks.end())
+      {
+        dlog("received transactions for compact block ${hash} we are not waiting for, ignoring", ("hash", block_message_hash));
+        return;
+      }
+      peer_connection::partial_compact_block partial_block = std::move(partial_block_iter->second);
+      originating_peer->partial_compact_blocks.erase(partial_block_iter);
+
+      const std::vector<signed_transaction>& received_transactions = compact_block_transactions_message_received.transactions;
+      bool transactions_match = received_transactions.size() == partial_block.missing_transaction_indices.size();
+      for (uint32_t i = 0; transactions_match && i < received_transactions.size(); ++i)
+      {
+        uint32_t index = partial_block.missing_transaction_indices[i];
+        transactions_match = message(trx_message(received_transactions[i])).id() ==
+                             partial_block.compact_block.transactions[index].transaction_message_hash;
+        partial_block.transactions[index] = received_transactions[i];
+      }
+
+      if (!transactions_match)
+      {
+        wlog("peer ${endpoint} sent transactions that don't match compact block ${hash}, requesting the full block",
+             ("endpoint", originating_peer->get_remote_endpoint())("hash", block_message_hash));
+        originating_peer->send_message(fetch_items_message(block_message_type, {block_message_hash}));
+        return;
+      }
+      finish_compact_block(originating_peer, partial_block.compact_block, std::move(partial_block.transactions));
+    }
+
+    void node_impl::finish_compact_block(peer_connection* originating_peer,
+                                         const compact_block_message& compact_block,
+                                         std::vector<fc::optional<signed_transaction> >&& transactions)
+    {
+      VERIFY_CORRECT_THREAD();
+      signed_block block;
+      static_cast<graphene::chain::signed_block_header&>(block) = compact_block.header;
+      block.transactions.reserve(transactions.size());
+      for (uint32_t i = 0; i < transactions.size(); ++i)
+      {
+        graphene::chain::processed_transaction transaction(std::move(*transactions[i]));
+        transaction.operation_results = compact_block.transactions[i].operation_results;
+        block.transactions.push_back(std::move(transaction));
+      }
+
+      // the rebuilt block must hash to exactly the block message we asked for, otherwise
+      // (a short id collision or a misbehaving peer) we fall back to fetching the full block
+      message block_message_to_process(graphene::net::block_message(block));
+      message_hash_type message_hash = block_message_to_process.id();
+      if (message_hash != compact_block.block_message_hash)
+      {
+        wlog("compact block ${hash} from peer ${endpoint} didn't rebuild to the advertised block, requesting the full block",
+             ("hash", compact_block.block_message_hash)("endpoint", originating_peer->get_remote_endpoint()));
+        originating_peer->send_message(fetch_items_message(block_message_type, {compact_block.block_message_hash}));
+        return;
+      }
+      process_block_message(originating_peer, block_message_to_process, message_hash);
+    }
+
     void node_impl::on_current_time_request_message(peer_connection* originating_peer,
                                                     const current_time_request_message& current_time_request_message_received)
     {
@@ -3375,6 +3826,7 @@ namespace graphene { namespace net { namespace detail {
       }
       else
       {
+        record_item_received( originating_peer, iter->second );
         originating_peer->items_requested_from_peer.erase( iter );
         if (originating_peer->idle())
           trigger_fetch_items_loop();
@@ -3432,6 +3884,7 @@ namespace graphene { namespace net { namespace detail {
     void node_impl::new_peer_just_added( const peer_connection_ptr& peer )
     {
       VERIFY_CORRECT_THREAD();
+      peer->last_round_trip_probe_time = fc::time_point::now();
       peer->send_message(current_time_request_message(),
                          offsetof(current_time_request_message, request_sent_time));
       start_synchronizing_with_peer( peer );
@@ -4256,7 +4709,6 @@ namespace graphene { namespace net { namespace detail {
       ilog( "--------- MEMORY USAGE ------------" );
       ilog( "node._active_sync_requests size: ${size}", ("size", _active_sync_requests.size() ) );
       ilog( "node._received_sync_items size: ${size}", ("size", _received_sync_items.size() ) );
-      ilog( "node._new_received_sync_items size: ${size}", ("size", _new_received_sync_items.size() ) );
       ilog( "node._items_to_fetch size: ${size}", ("size", _items_to_fetch.size() ) );
       ilog( "node._new_inventory size: ${size}", ("size", _new_inventory.size() ) );
       ilog( "node._message_cache size: ${size}", ("size", _message_cache.size() ) );
@@ -4424,6 +4876,35 @@ namespace graphene { namespace net { namespace detail {
       return statuses;
     }
 
+    std::vector<peer_telemetry> node_impl::get_peer_telemetry() const
+    {
+      VERIFY_CORRECT_THREAD();
+      std::vector<peer_telemetry> telemetry;
+      for (const peer_connection_ptr& peer : _active_connections)
+      {
+        ASSERT_TASK_NOT_PREEMPTED(); // don't yield while iterating over _active_connections
+
+        peer_telemetry this_peer_telemetry;
+        fc::optional<fc::ip::endpoint> endpoint = peer->get_remote_endpoint();
+        if (endpoint)
+          this_peer_telemetry.host = *endpoint;
+        this_peer_telemetry.node_id = peer->node_id;
+        this_peer_telemetry.round_trip_delay = peer->round_trip_delay;
+        this_peer_telemetry.item_service_time = peer->item_service_time;
+        this_peer_telemetry.sync_item_service_time = peer->sync_item_service_time;
+        this_peer_telemetry.download_rate = peer->download_rate;
+        this_peer_telemetry.upload_rate = peer->upload_rate;
+        this_peer_telemetry.items_received = peer->items_received;
+        this_peer_telemetry.sync_items_received = peer->sync_items_received;
+        this_peer_telemetry.item_requests_failed = peer->item_requests_failed;
+        this_peer_telemetry.sync_item_requests_failed = peer->sync_item_requests_failed;
+        this_peer_telemetry.items_in_flight = (uint32_t)peer->items_requested_from_peer.size();
+        this_peer_telemetry.sync_items_in_flight = (uint32_t)peer->sync_items_requested_from_peer.size();
+        telemetry.push_back(this_peer_telemetry);
+      }
+      return telemetry;
+    }
+
     uint32_t node_impl::get_connection_count() const
     {
       VERIFY_CORRECT_THREAD();
@@ -4501,6 +4982,14 @@ namespace graphene { namespace net { namespace detail {
         _maximum_number_of_sync_blocks_to_prefetch = params["maximum_number_of_sync_blocks_to_prefetch"].as<uint32_t>(1);
       if (params.contains("maximum_blocks_per_peer_during_syncing"))
         _maximum_blocks_per_peer_during_syncing = params["maximum_blocks_per_peer_during_syncing"].as<uint32_t>(1);
+      if (params.contains("compact_block_relay_enabled"))
+        _compact_block_relay_enabled = params["compact_block_relay_enabled"].as_bool();
+      if (params.contains("parallel_sync_enabled"))
+        _parallel_sync_enabled = params["parallel_sync_enabled"].as_bool();
+      if (params.contains("sync_reorder_window"))
+        _sync_reorder_window = params["sync_reorder_window"].as<uint32_t>(1);
+      if (params.contains("min_sync_item_request_timeout_ms"))
+        _min_sync_item_request_timeout = fc::milliseconds(params["min_sync_item_request_timeout_ms"].as<uint32_t>(1));
 
       _desired_number_of_connections = std::min(_desired_number_of_connections, _maximum_number_of_connections);
 
@@ -4520,6 +5009,10 @@ namespace graphene { namespace net { namespace detail {
       result["maximum_number_of_blocks_to_handle_at_one_time"] = _maximum_number_of_blocks_to_handle_at_one_time;
       result["maximum_number_of_sync_blocks_to_prefetch"] = _maximum_number_of_sync_blocks_to_prefetch;
       result["maximum_blocks_per_peer_during_syncing"] = _maximum_blocks_per_peer_during_syncing;
+      result["compact_block_relay_enabled"] = _compact_block_relay_enabled;
+      result["parallel_sync_enabled"] = _parallel_sync_enabled;
+      result["sync_reorder_window"] = _sync_reorder_window;
+      result["min_sync_item_request_timeout_ms"] = _min_sync_item_request_timeout.count() / 1000;
       return result;
     }
 
@@ -4712,6 +5205,11 @@ namespace graphene { namespace net { namespace detail {
     INVOKE_IN_IMPL(get_connected_peers);
   }
 
+  std::vector<peer_telemetry> node::get_peer_telemetry() const
+  {
+    INVOKE_IN_IMPL(get_peer_telemetry);
+  }
+
   uint32_t node::get_connection_count() const
   {
     INVOKE_IN_IMPL(get_connection_count);
@@ -207,8 +207,25 @@ class node_impl : public peer_connection_delegate
       typedef std::unordered_map<graphene::net::block_id_type, fc::time_point> active_sync_requests_map;
 
       active_sync_requests_map              _active_sync_requests; /// list of sync blocks we've asked for from peers but have not yet received
-      std::list<graphene::net::block_message> _new_received_sync_items; /// list of sync blocks we've just received but haven't yet tried to process
-      std::list<graphene::net::block_message> _received_sync_items; /// list of sync blocks we've received, but can't yet process because we are still missing blocks that come earlier in the chain
+      struct received_sync_block
+      {
+        graphene::net::block_message message;
+        uint32_t                     block_num;
+
+        explicit received_sync_block(const graphene::net::block_message& message) :
+          message(message),
+          block_num(graphene::chain::block_header::num_from_id(message.block_id))
+        {}
+
+        const item_hash_t& block_id() const { return message.block_id; }
+      };
+      struct block_id_index{};
+      typedef boost::multi_index_container<received_sync_block,
+                                           boost::multi_index::indexed_by<boost::multi_index::hashed_unique<boost::multi_index::tag<block_id_index>,
+                                                                                                            boost::multi_index::const_mem_fun<received_sync_block, const item_hash_t&, &received_sync_block::block_id>,
+                                                                                                            std::hash<item_hash_t> > >
+                                           > received_sync_blocks_set_type;
+      received_sync_blocks_set_type _received_sync_items; /// sync blocks we've received, but can't yet process because we are still missing blocks that come earlier in the chain
       // @}
 
       fc::future<void> _process_backlog_of_sync_blocks_done;
@@ -334,6 +351,10 @@ class node_impl : public peer_connection_delegate
       unsigned _maximum_number_of_blocks_to_handle_at_one_time;
       unsigned _maximum_number_of_sync_blocks_to_prefetch;
       unsigned _maximum_blocks_per_peer_during_syncing;
+      bool     _compact_block_relay_enabled; /// request blocks as compact_block_messages from peers that support it
+      bool     _parallel_sync_enabled; /// pipeline sync requests to all syncing peers, weighted by how fast each one delivers
+      unsigned _sync_reorder_window; /// with parallel sync, only request blocks this far ahead of the oldest block we still need
+      fc::microseconds _min_sync_item_request_timeout; /// with parallel sync, a peer that delivers no sync block for this long (or longer, if it is slow) has its outstanding requests reassigned
 
       std::list<fc::future<void> > _handle_message_calls_in_progress;
 
@@ -348,9 +369,12 @@ class node_impl : public peer_connection_delegate
       bool have_already_received_sync_item( const item_hash_t& item_hash );
       void request_sync_item_from_peer( const peer_connection_ptr& peer, const item_hash_t& item_to_request );
       void request_sync_items_from_peer( const peer_connection_ptr& peer, const std::vector<item_hash_t>& items_to_request );
+      void reassign_timed_out_sync_item_requests();
+      void schedule_parallel_sync_item_requests( std::map<peer_connection_ptr, std::vector<item_hash_t> >& sync_item_requests_to_send );
       void fetch_sync_items_loop();
       void trigger_fetch_sync_items_loop();
 
+      void record_item_received( peer_connection* peer, const fc::time_point& request_time );
       bool is_item_in_any_peers_inventory(const item_id& item) const;
       void fetch_items_loop();
       void trigger_fetch_items_loop();
@@ -362,6 +386,7 @@ class node_impl : public peer_connection_delegate
 
       void fetch_updated_peer_lists_loop();
       void update_bandwidth_data(uint32_t bytes_read_this_second, uint32_t bytes_written_this_second);
+      void update_peer_transfer_rates(uint32_t seconds_since_last_update);
       void bandwidth_monitor_loop();
       void dump_node_status_task();
 
@@ -416,6 +441,19 @@ class node_impl : public peer_connection_delegate
       void on_closing_connection_message( peer_connection* originating_peer,
                                           const closing_connection_message& closing_connection_message_received );
 
+      void on_compact_block_message( peer_connection* originating_peer,
+                                     const compact_block_message& compact_block_message_received );
+
+      void on_fetch_compact_block_transactions_message( peer_connection* originating_peer,
+                                                        const fetch_compact_block_transactions_message& fetch_compact_block_transactions_message_received );
+
+      void on_compact_block_transactions_message( peer_connection* originating_peer,
+                                                  const compact_block_transactions_message& compact_block_transactions_message_received );
+
+      void finish_compact_block( peer_connection* originating_peer,
+                                 const compact_block_message& compact_block,
+                                 std::vector<fc::optional<signed_transaction> >&& transactions );
+
       void on_current_time_request_message( peer_connection* originating_peer,
                                             const current_time_request_message& current_time_request_message_received );
 
@@ -490,6 +528,7 @@ class node_impl : public peer_connection_delegate
 
       fc::ip::endpoint         get_actual_listening_endpoint() const;
       std::vector<peer_status> get_connected_peers() const;
+      std::vector<peer_telemetry> get_peer_telemetry() const;
       uint32_t                 get_connection_count() const;
 
       void broadcast(const message& item_to_broadcast, const message_propagation_data& propagation_data);
@@ -510,6 +549,8 @@ class node_impl : public peer_connection_delegate
       void                       disable_peer_advertising();
       fc::variant_object         get_call_statistics() const;
       message                    get_message_for_item(const item_id& item) override;
+      /// the block_message from our message cache or else from the delegate, unset if we don't have the block
+      fc::optional<message>      find_block_message(const item_hash_t& block_message_hash);
 
       fc::variant_object         network_get_info() const;
       fc::variant_object         network_get_usage_stats() const;
@@ -86,6 +86,15 @@ namespace graphene { namespace net
       peer_needs_sync_items_from_us(true),
       we_need_sync_items_from_peer(true),
       inhibit_fetching_sync_blocks(false),
+      supports_compact_blocks(false),
+      items_received(0),
+      sync_items_received(0),
+      item_requests_failed(0),
+      sync_item_requests_failed(0),
+      download_rate(0),
+      upload_rate(0),
+      total_bytes_received_at_last_sample(0),
+      total_bytes_sent_at_last_sample(0),
       transaction_fetching_inhibited_until(fc::time_point::min()),
       last_known_fork_block_number(0),
       firewall_check_state(nullptr),
@@ -469,6 +478,16 @@ namespace graphene { namespace net
       return transaction_fetching_inhibited_until > fc::time_point::now();
     }
 
+    fc::microseconds peer_connection::get_expected_service_time(bool during_sync) const
+    {
+      VERIFY_CORRECT_THREAD();
+      fc::microseconds measured_service_time = during_sync ? sync_item_service_time : item_service_time;
+      if (measured_service_time > fc::microseconds())
+        return measured_service_time;
+      // until we've received something from them, the round trip delay is the best we have
+      return round_trip_delay > fc::microseconds() ? round_trip_delay : fc::microseconds();
+    }
+
     fc::sha512 peer_connection::get_shared_secret() const
     {
       VERIFY_CORRECT_THREAD();
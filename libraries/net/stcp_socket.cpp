@@ -80,14 +80,18 @@ void stcp_socket::bind( const fc::ip::endpoint& local_endpoint )
   _sock.bind(local_endpoint);
 }
 
+namespace {
+  /// Size of the reused ciphertext and plaintext buffers, large enough for most messages in one socket read
+  const size_t stcp_buffer_length = 64 * 1024;
+}
+
 /**
- *   This method must read at least 16 bytes at a time from
- *   the underlying TCP socket so that it can decrypt them. It
- *   will buffer any left-over.
+ *   Reads whatever the TCP socket has available (at least 16 bytes, the AES block size) and decrypts all of
+ *   it at once. Bytes the caller did not ask for are kept decrypted and returned by the next calls.
  */
 size_t stcp_socket::readsome( char* buffer, size_t len )
 { try {
-    assert( len > 0 && (len % 16) == 0 );
+    assert( len > 0 );
 
 #ifndef NDEBUG
     // This code was written with the assumption that you'd only be making one call to readsome 
@@ -100,20 +104,40 @@ size_t stcp_socket::readsome( char* buffer, size_t len )
     } buffer_in_use_checker(_read_buffer_in_use);
 #endif
 
-    const size_t read_buffer_length = 4096;
-    if (!_read_buffer)
-      _read_buffer.reset(new char[read_buffer_length], [](char* p){ delete[] p; });
+    if( _decrypted_begin < _decrypted_end )
+    {
+      const size_t s = std::min<size_t>( len, _decrypted_end - _decrypted_begin );
+      memcpy( buffer, _decrypted_buffer.get() + _decrypted_begin, s );
+      _decrypted_begin += s;
+      return s;
+    }
 
-    len = std::min<size_t>(read_buffer_length, len);
+    if (!_read_buffer)
+    {
+      _read_buffer.reset(new char[stcp_buffer_length], [](char* p){ delete[] p; });
+      _decrypted_buffer.reset(new char[stcp_buffer_length]);
+    }
 
-    size_t s = _sock.readsome( _read_buffer, len, 0 );
+    size_t s = _sock.readsome( _read_buffer, stcp_buffer_length, 0 );
     if( s % 16 ) 
     {
       _sock.read(_read_buffer, 16 - (s%16), s);
       s += 16-(s%16);
     }
-    _recv_aes.decode( _read_buffer.get(), s, buffer );
-    return s;
+
+    // Decrypt directly into the caller's buffer when everything read fits, which is the usual case for the body
+    // of a large message
+    if( s <= len )
+    {
+      _recv_aes.decode( _read_buffer.get(), s, buffer );
+      return s;
+    }
+
+    _recv_aes.decode( _read_buffer.get(), s, _decrypted_buffer.get() );
+    memcpy( buffer, _decrypted_buffer.get(), len );
+    _decrypted_begin = len;
+    _decrypted_end = s;
+    return len;
 } FC_RETHROW_EXCEPTIONS( warn, "", ("len",len) ) }
 
 size_t stcp_socket::readsome( const std::shared_ptr<char>& buf, size_t len, size_t offset ) 
@@ -141,23 +165,91 @@ size_t stcp_socket::writesome( const char* buffer, size_t len )
     } buffer_in_use_checker(_write_buffer_in_use);
 #endif
 
-    const std::size_t write_buffer_length = 4096;
-    if (!_write_buffer)
-      _write_buffer.reset(new char[write_buffer_length], [](char* p){ delete[] p; });
-    len = std::min<size_t>(write_buffer_length, len);
-    memset(_write_buffer.get(), 0, len); // just in case aes.encode screws up
-    /**
-     * every sizeof(crypt_buf) bytes the aes channel
-     * has an error and doesn't decrypt properly...  disable
-     * for now because we are going to upgrade to something
-     * better.
-     */
-    uint32_t ciphertext_len = _send_aes.encode( buffer, len, _write_buffer.get() );
-    assert(ciphertext_len == len);
-    _sock.write( _write_buffer, ciphertext_len );
-    return ciphertext_len;
+    len = std::min<size_t>(stcp_buffer_length, len);
+    encrypt_to_write_buffer( buffer, len );
+    flush_write_buffer();
+    return len;
 } FC_RETHROW_EXCEPTIONS( warn, "", ("len",len) ) }
 
+size_t stcp_socket::write_gather( const std::vector<std::pair<const char*, size_t>>& parts )
+{ try {
+#ifndef NDEBUG
+    struct check_buffer_in_use {
+      bool& _buffer_in_use;
+      check_buffer_in_use(bool& buffer_in_use) : _buffer_in_use(buffer_in_use) { assert(!_buffer_in_use); _buffer_in_use = true; }
+      ~check_buffer_in_use() { assert(_buffer_in_use); _buffer_in_use = false; }
+    } buffer_in_use_checker(_write_buffer_in_use);
+#endif
+
+    // Only the AES blocks spanning two parts and the padded tail are assembled in a separate block, everything
+    // else is encrypted straight from the parts
+    char block[16];
+    size_t block_used = 0;
+    size_t total = 0;
+    for( const auto& part : parts )
+    {
+      const char* data = part.first;
+      size_t remaining = part.second;
+      total += remaining;
+
+      if( block_used > 0 )
+      {
+        const size_t n = std::min<size_t>( remaining, sizeof(block) - block_used );
+        memcpy( block + block_used, data, n );
+        block_used += n;
+        data += n;
+        remaining -= n;
+        if( block_used < sizeof(block) )
+          continue;
+        encrypt_to_write_buffer( block, sizeof(block) );
+        block_used = 0;
+      }
+
+      const size_t aligned = remaining - remaining % 16;
+      if( aligned > 0 )
+        encrypt_to_write_buffer( data, aligned );
+      memcpy( block, data + aligned, remaining - aligned );
+      block_used = remaining - aligned;
+    }
+
+    if( block_used > 0 )
+    {
+      memset( block + block_used, 0, sizeof(block) - block_used );
+      encrypt_to_write_buffer( block, sizeof(block) );
+      total += sizeof(block) - block_used;
+    }
+    flush_write_buffer();
+    return total;
+} FC_RETHROW_EXCEPTIONS( warn, "" ) }
+
+void stcp_socket::encrypt_to_write_buffer( const char* plaintext, size_t len )
+{
+    assert( len % 16 == 0 );
+    if (!_write_buffer)
+      _write_buffer.reset(new char[stcp_buffer_length], [](char* p){ delete[] p; });
+
+    while( len > 0 )
+    {
+      if( _write_buffer_used == stcp_buffer_length )
+        flush_write_buffer();
+      const size_t n = std::min<size_t>( len, stcp_buffer_length - _write_buffer_used );
+      uint32_t ciphertext_len = _send_aes.encode( plaintext, n, _write_buffer.get() + _write_buffer_used );
+      assert(ciphertext_len == n);
+      _write_buffer_used += ciphertext_len;
+      plaintext += n;
+      len -= n;
+    }
+}
+
+void stcp_socket::flush_write_buffer()
+{
+    if( _write_buffer_used == 0 )
+      return;
+    const size_t len = _write_buffer_used;
+    _write_buffer_used = 0;
+    _sock.write( _write_buffer, len );
+}
+
 size_t stcp_socket::writesome( const std::shared_ptr<const char>& buf, size_t len, size_t offset )
 {
   return writesome(buf.get() + offset, len);
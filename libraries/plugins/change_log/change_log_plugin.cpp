@@ -0,0 +1,387 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <graphene/change_log/change_log_plugin.hpp>
+#include <graphene/chain/operation_history_object.hpp>
+
+#include <fc/smart_ref_impl.hpp>
+#include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/io/raw_variant.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/signals2/connection.hpp>
+
+#include <cstdio>
+#include <fstream>
+
+namespace graphene { namespace change_log {
+
+namespace detail
+{
+
+class change_log_plugin_impl
+{
+   public:
+      change_log_plugin_impl(change_log_plugin& _plugin)
+         : _self( _plugin )
+      { }
+      virtual ~change_log_plugin_impl();
+
+      void open();
+      void on_applied_block( const signed_block& b );
+      void on_objects( change_kind kind, const vector<object_id_type>& ids, const vector<const object*>* removed );
+      void flush_block();
+
+      change_log_plugin& _self;
+      /// Last block whose records are complete in the log, 0 if none
+      uint32_t _last_logged_block_num = 0;
+      boost::filesystem::path _change_log_dir;
+      bool _change_log_binary = false;
+      uint64_t _change_log_segment_size = 64 * 1024 * 1024;
+      flat_set<std::pair<uint8_t, uint8_t>> _change_log_ignored_types;
+
+      // Disconnected when the plugin goes away, the database may outlive it
+      boost::signals2::scoped_connection _applied_block_connection;
+      boost::signals2::scoped_connection _new_objects_connection;
+      boost::signals2::scoped_connection _changed_objects_connection;
+      boost::signals2::scoped_connection _removed_objects_connection;
+
+   private:
+      std::string extension()const { return _change_log_binary ? ".bin" : ".ndjson"; }
+      bool is_ignored( object_id_type id )const;
+      void open_segment( uint64_t first_sequence );
+      uint64_t recover_segment( const boost::filesystem::path& segment );
+      void write_record( const change_record& record );
+
+      std::ofstream _segment;
+      uint64_t _segment_bytes = 0;
+      uint64_t _next_sequence = 0;
+
+      // Records of the block being applied, written once all of its object changes are known
+      vector<change_record> _block_records;
+      bool _block_pending = false;
+      uint32_t _block_num = 0;
+      block_id_type _block_id;
+      fc::time_point_sec _block_time;
+};
+
+void change_log_plugin_impl::open()
+{
+   boost::filesystem::create_directories( _change_log_dir );
+
+   // Continue after the last complete block of the most recent segment
+   boost::filesystem::path last_segment;
+   uint64_t last_first_sequence = 0;
+   for( boost::filesystem::directory_iterator itr( _change_log_dir ), end; itr != end; ++itr )
+   {
+      const auto& path = itr->path();
+      if( path.extension().string() != extension() )
+         continue;
+      const uint64_t first_sequence = std::stoull( path.stem().string() );
+      if( last_segment.empty() || first_sequence > last_first_sequence )
+      {
+         last_segment = path;
+         last_first_sequence = first_sequence;
+      }
+   }
+
+   if( last_segment.empty() )
+   {
+      open_segment( 0 );
+      return;
+   }
+
+   _next_sequence = last_first_sequence + recover_segment( last_segment );
+   _segment_bytes = boost::filesystem::file_size( last_segment );
+   _segment.open( last_segment.string(), std::ios::binary | std::ios::app );
+   FC_ASSERT( _segment.good(), "Unable to open change log segment ${s}", ("s", last_segment.string()) );
+   ilog( "change_log: appending to ${s}, next sequence ${n}", ("s", last_segment.string())("n", _next_sequence) );
+}
+
+uint64_t change_log_plugin_impl::recover_segment( const boost::filesystem::path& segment )
+{
+   // Count the records up to the last block_end, a block cut short by a crash is truncated away
+   std::ifstream in( segment.string(), std::ios::binary );
+   const uint64_t total_bytes = boost::filesystem::file_size( segment );
+   uint64_t records = 0;
+   uint64_t bytes = 0;
+   uint64_t complete_records = 0;
+   uint64_t complete_bytes = 0;
+   auto on_record = [&]( const change_record& record ) {
+      ++records;
+      if( record.kind == block_end )
+      {
+         complete_records = records;
+         complete_bytes = bytes;
+         _last_logged_block_num = record.block_num;
+      }
+   };
+   try
+   {
+      if( _change_log_binary )
+      {
+         uint32_t size = 0;
+         std::vector<char> data;
+         while( bytes + sizeof( size ) <= total_bytes && in.read( reinterpret_cast<char*>( &size ), sizeof( size ) ) )
+         {
+            if( bytes + sizeof( size ) + size > total_bytes )
+               break;
+            data.resize( size );
+            in.read( data.data(), size );
+            bytes += sizeof( size ) + size;
+            on_record( fc::raw::unpack<change_record>( data ) );
+         }
+      }
+      else
+      {
+         std::string line;
+         while( std::getline( in, line ) )
+         {
+            if( in.eof() )
+               break;
+            bytes += line.size() + 1;
+            on_record( fc::json::from_string( line ).as<change_record>( GRAPHENE_MAX_NESTED_OBJECTS ) );
+         }
+      }
+   }
+   catch( const fc::exception& )
+   {
+      wlog( "change_log: unreadable record in ${s} after ${n} records", ("s", segment.string())("n", records) );
+   }
+   in.close();
+
+   if( complete_bytes < total_bytes )
+   {
+      wlog( "change_log: dropping ${n} records of an incomplete block at the end of ${s}",
+            ("n", records - complete_records)("s", segment.string()) );
+      boost::filesystem::resize_file( segment, complete_bytes );
+   }
+   return complete_records;
+}
+
+void change_log_plugin_impl::open_segment( uint64_t first_sequence )
+{
+   if( _segment.is_open() )
+      _segment.close();
+
+   char name[32];
+   snprintf( name, sizeof( name ), "%020llu", static_cast<unsigned long long>( first_sequence ) );
+   const auto path = _change_log_dir / ( std::string( name ) + extension() );
+   _segment.open( path.string(), std::ios::binary | std::ios::app );
+   FC_ASSERT( _segment.good(), "Unable to open change log segment ${s}", ("s", path.string()) );
+   _segment_bytes = 0;
+}
+
+bool change_log_plugin_impl::is_ignored( object_id_type id )const
+{
+   return _change_log_ignored_types.find( std::make_pair( id.space(), id.type() ) ) != _change_log_ignored_types.end();
+}
+
+void change_log_plugin_impl::on_applied_block( const signed_block& b )
+{
+   // Without the undo database no object notifications follow, so the previous block is still waiting
+   if( _block_pending )
+      flush_block();
+
+   _block_num = b.block_num();
+   _block_id = b.id();
+   _block_time = b.timestamp;
+   _block_pending = true;
+
+   for( const auto& op : _self.database().get_applied_operations() )
+   {
+      if( !op.valid() )
+         continue;
+      change_record record;
+      record.kind = op_applied;
+      record.data = fc::variant( *op, GRAPHENE_MAX_NESTED_OBJECTS );
+      _block_records.push_back( std::move( record ) );
+   }
+}
+
+void change_log_plugin_impl::on_objects( change_kind kind, const vector<object_id_type>& ids,
+                                         const vector<const object*>* removed )
+{
+   // Changes notified in the middle of a block are notified again with the rest of the block
+   if( !_block_pending )
+      return;
+
+   const auto& db = _self.database();
+   for( size_t i = 0; i < ids.size(); ++i )
+   {
+      if( is_ignored( ids[i] ) )
+         continue;
+      const object* obj = removed != nullptr ? (*removed)[i] : db.find_object( ids[i] );
+      if( obj == nullptr )
+         continue;
+      change_record record;
+      record.kind = kind;
+      record.object_id = ids[i];
+      record.data = obj->to_variant();
+      _block_records.push_back( std::move( record ) );
+   }
+}
+
+void change_log_plugin_impl::flush_block()
+{
+   if( !_block_pending )
+      return;
+   _block_pending = false;
+
+   if( _segment_bytes >= _change_log_segment_size )
+      open_segment( _next_sequence );
+
+   change_record end;
+   end.kind = block_end;
+   end.data = fc::variant( uint64_t( _block_records.size() ) );
+   _block_records.push_back( std::move( end ) );
+
+   for( auto& record : _block_records )
+   {
+      record.sequence = _next_sequence++;
+      record.block_num = _block_num;
+      record.block_id = _block_id;
+      record.block_time = _block_time;
+      write_record( record );
+   }
+   _segment.flush();
+   FC_ASSERT( _segment.good(), "Error writing change log of block ${b}", ("b", _block_num) );
+   _block_records.clear();
+   _last_logged_block_num = _block_num;
+}
+
+void change_log_plugin_impl::write_record( const change_record& record )
+{
+   if( _change_log_binary )
+   {
+      const auto data = fc::raw::pack( record );
+      const uint32_t size = data.size();
+      _segment.write( reinterpret_cast<const char*>( &size ), sizeof( size ) );
+      _segment.write( data.data(), data.size() );
+      _segment_bytes += sizeof( size ) + data.size();
+   }
+   else
+   {
+      const auto line = fc::json::to_string( fc::variant( record, GRAPHENE_MAX_NESTED_OBJECTS ) ) + "\n";
+      _segment.write( line.data(), line.size() );
+      _segment_bytes += line.size();
+   }
+}
+
+change_log_plugin_impl::~change_log_plugin_impl()
+{
+   return;
+}
+
+} // end namespace detail
+
+change_log_plugin::change_log_plugin() :
+   my( new detail::change_log_plugin_impl(*this) )
+{
+}
+
+change_log_plugin::~change_log_plugin()
+{
+}
+
+std::string change_log_plugin::plugin_name()const
+{
+   return "change_log";
+}
+std::string change_log_plugin::plugin_description()const
+{
+   return "Writes operations and object changes of every block to a local, segmented change log.";
+}
+
+void change_log_plugin::plugin_set_program_options(
+   boost::program_options::options_description& cli,
+   boost::program_options::options_description& cfg
+   )
+{
+   cli.add_options()
+         ("change-log-dir", boost::program_options::value<boost::filesystem::path>(), "Directory of the change log segments")
+         ("change-log-format", boost::program_options::value<std::string>(), "Format of the change log segments, ndjson or binary(ndjson)")
+         ("change-log-segment-size", boost::program_options::value<uint64_t>(), "Size in bytes after which a new segment is started(67108864)")
+         ("change-log-ignore-objects", boost::program_options::value<std::vector<std::string>>()->composing()->multitoken(),
+          "Object types not to log as space.type, e.g. 2.1 for the dynamic global properties(none)")
+         ;
+   cfg.add(cli);
+}
+
+void change_log_plugin::plugin_initialize(const boost::program_options::variables_map& options)
+{
+   FC_ASSERT( options.count("change-log-dir"), "The change_log plugin requires change-log-dir" );
+   my->_change_log_dir = options["change-log-dir"].as<boost::filesystem::path>();
+
+   if (options.count("change-log-format")) {
+      const auto format = options["change-log-format"].as<std::string>();
+      FC_ASSERT( format == "ndjson" || format == "binary", "Unknown change log format ${f}", ("f", format) );
+      my->_change_log_binary = format == "binary";
+   }
+   if (options.count("change-log-segment-size")) {
+      my->_change_log_segment_size = options["change-log-segment-size"].as<uint64_t>();
+   }
+   if (options.count("change-log-ignore-objects")) {
+      for( const auto& type : options["change-log-ignore-objects"].as<std::vector<std::string>>() )
+      {
+         const auto dot = type.find('.');
+         FC_ASSERT( dot != std::string::npos, "Object type ${t} is not space.type", ("t", type) );
+         my->_change_log_ignored_types.emplace( std::stoi( type.substr( 0, dot ) ), std::stoi( type.substr( dot + 1 ) ) );
+      }
+   }
+
+   my->open();
+
+   my->_applied_block_connection = database().applied_block.connect([this]( const signed_block& b ) {
+      my->on_applied_block( b );
+   });
+   my->_new_objects_connection = database().new_objects.connect([this]( const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts ) {
+      my->on_objects( change_kind::object_created, ids, nullptr );
+   });
+   my->_changed_objects_connection = database().changed_objects.connect([this]( const vector<object_id_type>& ids, const flat_set<account_id_type>& impacted_accounts ) {
+      my->on_objects( change_kind::object_updated, ids, nullptr );
+   });
+   // Removed objects are notified last, the block is complete at that point
+   my->_removed_objects_connection = database().removed_objects.connect([this]( const vector<object_id_type>& ids, const vector<const object*>& objs, const flat_set<account_id_type>& impacted_accounts ) {
+      my->on_objects( change_kind::object_removed, ids, &objs );
+      my->flush_block();
+   });
+}
+
+void change_log_plugin::plugin_startup()
+{
+   // Blocks applied before a crash, but whose records were dropped as incomplete, are not applied again
+   const uint32_t head_block_num = database().head_block_num();
+   if( my->_last_logged_block_num > 0 && my->_last_logged_block_num < head_block_num )
+      wlog( "change_log: blocks ${f} to ${t} are missing from the change log",
+            ("f", my->_last_logged_block_num + 1)("t", head_block_num) );
+}
+
+void change_log_plugin::plugin_shutdown()
+{
+   my->flush_block();
+}
+
+} }
@@ -0,0 +1,105 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/app/plugin.hpp>
+#include <graphene/chain/database.hpp>
+
+namespace graphene { namespace change_log {
+
+using namespace chain;
+
+namespace detail
+{
+    class change_log_plugin_impl;
+}
+
+/**
+ *  Writes an append-only log of everything a block changed: the operations it applied (including virtual ones)
+ *  followed by every object it created, updated or removed, DasCoin objects (reward queue, licences, das33 pledges,
+ *  DasPay delayed operations...) included. It is meant to feed analytics and off-line historical queries without
+ *  an Elasticsearch cluster.
+ *
+ *  The log is split into segments named after the sequence number of their first record, <20 digits>.ndjson or
+ *  <20 digits>.bin. A segment is closed once it grows beyond change-log-segment-size, at a block boundary, so
+ *  the records of a block never span two segments. Sequence numbers grow by one per record and are never reused,
+ *  a consumer keeps the last sequence it processed as its cursor and resumes from the segment with the greatest
+ *  first sequence not above it.
+ *
+ *  The ndjson format is one JSON @ref change_record per line, the binary format is a little endian uint32 length
+ *  followed by the fc::raw packed @ref change_record. Objects are logged with their state after the block, removed
+ *  objects with their last state. The records of every block end with a block_end record whose data is the number
+ *  of records before it; on startup a segment is truncated after its last block_end, so a block cut short by a
+ *  crash is dropped as a whole and shows as a block_num gap rather than as a block with records missing. When a fork switch re-applies blocks their records are appended again, consumers
+ *  detect it by a block_num that does not follow the previous one.
+ *
+ *  Object changes are only known while the undo database is enabled, so blocks applied during a replay only log
+ *  their operations.
+ */
+class change_log_plugin : public graphene::app::plugin
+{
+   public:
+      change_log_plugin();
+      virtual ~change_log_plugin();
+
+      std::string plugin_name()const override;
+      std::string plugin_description()const override;
+      virtual void plugin_set_program_options(
+         boost::program_options::options_description& cli,
+         boost::program_options::options_description& cfg) override;
+      virtual void plugin_initialize(const boost::program_options::variables_map& options) override;
+      virtual void plugin_startup() override;
+      virtual void plugin_shutdown() override;
+
+      friend class detail::change_log_plugin_impl;
+      std::unique_ptr<detail::change_log_plugin_impl> my;
+};
+
+enum change_kind
+{
+   op_applied,
+   object_created,
+   object_updated,
+   object_removed,
+   block_end
+};
+
+struct change_record
+{
+   uint64_t                 sequence = 0;
+   uint32_t                 block_num = 0;
+   block_id_type            block_id;
+   fc::time_point_sec       block_time;
+   change_kind              kind = op_applied;
+   /// set for object records
+   optional<object_id_type> object_id;
+   /// the operation_history_object for operations, the number of the block's other records for block_end,
+   /// the object otherwise
+   fc::variant              data;
+};
+
+} } //graphene::change_log
+
+FC_REFLECT_ENUM( graphene::change_log::change_kind, (op_applied)(object_created)(object_updated)(object_removed)(block_end) )
+FC_REFLECT( graphene::change_log::change_record, (sequence)(block_num)(block_id)(block_time)(kind)(object_id)(data) )
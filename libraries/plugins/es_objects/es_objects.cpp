@@ -33,6 +33,13 @@
 
 #include <graphene/utilities/elasticsearch.hpp>
 
+#include <boost/filesystem.hpp>
+
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <set>
+
 
 namespace graphene { namespace es_objects {
 
@@ -49,6 +56,7 @@ class es_objects_plugin_impl
 
       bool index_database( const vector<object_id_type>& ids, std::string action);
       void remove_from_database( object_id_type id, std::string index);
+      void load_spilled();
 
       es_objects_plugin& _self;
       std::string _es_objects_elasticsearch_url = "http://localhost:9200/";
@@ -67,11 +75,35 @@ class es_objects_plugin_impl
       vector<std::string> prepare;
 
       bool _es_objects_keep_only_current = true;
+      uint64_t _es_objects_max_buffer_size = 256 * 1024 * 1024;
+      std::string _es_objects_spill_dir = "";
 
       uint32_t block_number;
       fc::time_point_sec block_time;
 
    private:
+      struct pending_object
+      {
+         bool remove = false;
+         uint32_t block_number = 0;
+         fc::time_point_sec block_time;
+      };
+
+      bool is_indexed(object_id_type id)const;
+      std::string index_name(object_id_type id)const;
+      void prepare_object(const object& obj);
+      void prepare_pending();
+      void add_to_bulk();
+      bool send_bulk();
+      bool send_lines(vector<std::string>& lines);
+      bool spill();
+
+      // Latest change of every object since the last bulk, when keeping only the current state of the objects
+      std::map<object_id_type, pending_object> pending;
+      uint64_t bulk_size = 0;
+      std::deque<std::string> spilled_files;
+      uint64_t spill_count = 0;
+
       void prepare_proposal(const proposal_object& proposal_object);
       void prepare_account(const account_object& account_object);
       void prepare_asset(const asset_object& asset_object);
@@ -95,85 +127,177 @@ bool es_objects_plugin_impl::index_database( const vector<object_id_type>& ids,
       limit_documents = _es_objects_bulk_replay;
 
    for(auto const& value: ids) {
-      if(value.is<proposal_object>() && _es_objects_proposals) {
-         auto obj = db.find_object(value);
-         auto p = static_cast<const proposal_object*>(obj);
-         if(p != nullptr) {
-            if(action == "delete")
-               remove_from_database(p->id, "proposal");
-            else
-               prepare_proposal(*p);
-         }
-      }
-      else if(value.is<account_object>() && _es_objects_accounts) {
-         auto obj = db.find_object(value);
-         auto a = static_cast<const account_object*>(obj);
-         if(a != nullptr) {
-            if(action == "delete")
-               remove_from_database(a->id, "account");
-            else
-               prepare_account(*a);
-         }
+      if(!is_indexed(value))
+         continue;
+      if(_es_objects_keep_only_current) {
+         // intermediate versions would be overwritten anyway, only the last change is sent
+         auto& p = pending[value];
+         p.remove = (action == "delete");
+         p.block_number = block_number;
+         p.block_time = block_time;
       }
-      else if(value.is<asset_object>() && _es_objects_assets) {
+      else if(action != "delete") {
          auto obj = db.find_object(value);
-         auto a = static_cast<const asset_object*>(obj);
-         if(a != nullptr) {
-            if(action == "delete")
-               remove_from_database(a->id, "asset");
-            else
-               prepare_asset(*a);
-         }
-      }
-      else if(value.is<account_balance_object>() && _es_objects_balances) {
-         auto obj = db.find_object(value);
-         auto b = static_cast<const account_balance_object*>(obj);
-         if(b != nullptr) {
-            if(action == "delete")
-               remove_from_database(b->id, "balance");
-            else
-               prepare_balance(*b);
-         }
-      }
-      else if(value.is<limit_order_object>() && _es_objects_limit_orders) {
-         auto obj = db.find_object(value);
-         auto l = static_cast<const limit_order_object*>(obj);
-         if(l != nullptr) {
-            if(action == "delete")
-               remove_from_database(l->id, "limitorder");
-            else
-               prepare_limit(*l);
-         }
-      }
-      else if(value.is<asset_bitasset_data_object>() && _es_objects_asset_bitasset) {
-         auto obj = db.find_object(value);
-         auto ba = static_cast<const asset_bitasset_data_object*>(obj);
-         if(ba != nullptr) {
-            if(action == "delete")
-               remove_from_database(ba->id, "bitasset");
-            else
-               prepare_bitasset(*ba);
-         }
+         if(obj != nullptr)
+            prepare_object(*obj);
       }
    }
 
-   if (curl && bulk.size() >= limit_documents) { // we are in bulk time, ready to add data to elasticsearech
+   if (curl && (pending.size() + bulk.size() >= limit_documents || bulk_size >= _es_objects_max_buffer_size)) {
+      prepare_pending();
+      return send_bulk();
+   }
+
+   return true;
+}
+
+bool es_objects_plugin_impl::is_indexed(object_id_type id)const
+{
+   return (id.is<proposal_object>() && _es_objects_proposals)
+       || (id.is<account_object>() && _es_objects_accounts)
+       || (id.is<asset_object>() && _es_objects_assets)
+       || (id.is<account_balance_object>() && _es_objects_balances)
+       || (id.is<limit_order_object>() && _es_objects_limit_orders)
+       || (id.is<asset_bitasset_data_object>() && _es_objects_asset_bitasset);
+}
+
+std::string es_objects_plugin_impl::index_name(object_id_type id)const
+{
+   if(id.is<proposal_object>())
+      return "proposal";
+   if(id.is<account_object>())
+      return "account";
+   if(id.is<asset_object>())
+      return "asset";
+   if(id.is<account_balance_object>())
+      return "balance";
+   if(id.is<limit_order_object>())
+      return "limitorder";
+   return "bitasset";
+}
 
-      graphene::utilities::ES es;
-      es.curl = curl;
-      es.bulk_lines = bulk;
-      es.elasticsearch_url = _es_objects_elasticsearch_url;
-      es.auth = _es_objects_auth;
+void es_objects_plugin_impl::prepare_object(const object& obj)
+{
+   if(obj.id.is<proposal_object>())
+      prepare_proposal(static_cast<const proposal_object&>(obj));
+   else if(obj.id.is<account_object>())
+      prepare_account(static_cast<const account_object&>(obj));
+   else if(obj.id.is<asset_object>())
+      prepare_asset(static_cast<const asset_object&>(obj));
+   else if(obj.id.is<account_balance_object>())
+      prepare_balance(static_cast<const account_balance_object&>(obj));
+   else if(obj.id.is<limit_order_object>())
+      prepare_limit(static_cast<const limit_order_object&>(obj));
+   else if(obj.id.is<asset_bitasset_data_object>())
+      prepare_bitasset(static_cast<const asset_bitasset_data_object&>(obj));
+}
 
-      if(!graphene::utilities::SendBulk(std::move(es)))
-         return false;
-      else
-         bulk.clear();
+void es_objects_plugin_impl::prepare_pending()
+{
+   graphene::chain::database &db = _self.database();
+   for(const auto& p : pending) {
+      auto obj = p.second.remove ? nullptr : db.find_object(p.first);
+      if(obj == nullptr) {
+         remove_from_database(p.first, index_name(p.first));
+         continue;
+      }
+      block_number = p.second.block_number;
+      block_time = p.second.block_time;
+      prepare_object(*obj);
+   }
+   pending.clear();
+}
+
+void es_objects_plugin_impl::add_to_bulk()
+{
+   for(auto& line : prepare) {
+      bulk_size += line.size();
+      bulk.push_back(std::move(line));
+   }
+   prepare.clear();
+}
+
+bool es_objects_plugin_impl::send_bulk()
+{
+   // batches spilled while ES was behind are older than the current one and are sent first
+   while(!spilled_files.empty()) {
+      vector<std::string> lines;
+      std::ifstream in(spilled_files.front());
+      std::string line;
+      while(std::getline(in, line))
+         if(!line.empty())
+            lines.push_back(std::move(line));
+      in.close();
+
+      if(!send_lines(lines))
+         return spill();
+      boost::filesystem::remove(spilled_files.front());
+      spilled_files.pop_front();
    }
 
+   if(bulk.empty())
+      return true;
+   if(!send_lines(bulk))
+      return spill();
+   bulk.clear();
+   bulk_size = 0;
    return true;
 }
 
+bool es_objects_plugin_impl::send_lines(vector<std::string>& lines)
+{
+   graphene::utilities::ES es;
+   es.curl = curl;
+   es.bulk_lines = std::move(lines);
+   es.elasticsearch_url = _es_objects_elasticsearch_url;
+   es.auth = _es_objects_auth;
+
+   // SendBulk only reads the lines, they are handed back for a retry
+   const bool sent = graphene::utilities::SendBulk(std::move(es));
+   lines = std::move(es.bulk_lines);
+   return sent;
+}
+
+bool es_objects_plugin_impl::spill()
+{
+   // without a spill directory the documents stay in memory until ES accepts them
+   if(_es_objects_spill_dir.empty())
+      return false;
+   if(bulk.empty())
+      return true;
+
+   // names sort in spill order, also across restarts
+   char name[48];
+   snprintf(name, sizeof(name), "%010u-%010llu.bulk", fc::time_point::now().sec_since_epoch(),
+            static_cast<unsigned long long>(++spill_count));
+   const auto file = (boost::filesystem::path(_es_objects_spill_dir) / name).string();
+   std::ofstream out(file);
+   out << graphene::utilities::joinBulkLines(bulk);
+   out.close();
+   FC_ASSERT(out.good(), "Unable to spill ES documents to ${f}", ("f", file));
+
+   wlog("ES is behind, spilled ${n} bulk lines to ${f}", ("n", bulk.size())("f", file));
+   spilled_files.push_back(file);
+   bulk.clear();
+   bulk_size = 0;
+   return true;
+}
+
+void es_objects_plugin_impl::load_spilled()
+{
+   if(_es_objects_spill_dir.empty())
+      return;
+   boost::filesystem::create_directories(_es_objects_spill_dir);
+
+   std::set<std::string> files;
+   for(boost::filesystem::directory_iterator itr(_es_objects_spill_dir), end; itr != end; ++itr)
+      if(itr->path().extension() == ".bulk")
+         files.insert(itr->path().string());
+   spilled_files.assign(files.begin(), files.end());
+   if(!spilled_files.empty())
+      ilog("${n} spilled ES bulks left from the previous run", ("n", spilled_files.size()));
+}
+
 void es_objects_plugin_impl::remove_from_database( object_id_type id, std::string index)
 {
    if(_es_objects_keep_only_current)
@@ -185,8 +309,7 @@ void es_objects_plugin_impl::remove_from_database( object_id_type id, std::strin
       fc::mutable_variant_object final_delete_line;
       final_delete_line["delete"] = delete_line;
       prepare.push_back(fc::json::to_string(final_delete_line));
-      std::move(prepare.begin(), prepare.end(), std::back_inserter(bulk));
-      prepare.clear();
+      add_to_bulk();
    }
 }
 
@@ -216,8 +339,7 @@ void es_objects_plugin_impl::prepare_proposal(const proposal_object& proposal_ob
    }
 
    prepare = graphene::utilities::createBulk(bulk_header, std::move(data));
-   std::move(prepare.begin(), prepare.end(), std::back_inserter(bulk));
-   prepare.clear();
+   add_to_bulk();
 }
 
 void es_objects_plugin_impl::prepare_account(const account_object& account_object)
@@ -255,8 +377,7 @@ void es_objects_plugin_impl::prepare_account(const account_object& account_objec
    }
 
    prepare = graphene::utilities::createBulk(bulk_header, std::move(data));
-   std::move(prepare.begin(), prepare.end(), std::back_inserter(bulk));
-   prepare.clear();
+   add_to_bulk();
 }
 
 void es_objects_plugin_impl::prepare_asset(const asset_object& asset_object)
@@ -282,8 +403,7 @@ void es_objects_plugin_impl::prepare_asset(const asset_object& asset_object)
    }
 
    prepare = graphene::utilities::createBulk(bulk_header, std::move(data));
-   std::move(prepare.begin(), prepare.end(), std::back_inserter(bulk));
-   prepare.clear();
+   add_to_bulk();
 }
 
 void es_objects_plugin_impl::prepare_balance(const account_balance_object& account_balance_object)
@@ -312,8 +432,7 @@ void es_objects_plugin_impl::prepare_balance(const account_balance_object& accou
    }
 
    prepare = graphene::utilities::createBulk(bulk_header, std::move(data));
-   std::move(prepare.begin(), prepare.end(), std::back_inserter(bulk));
-   prepare.clear();
+   add_to_bulk();
 }
 
 void es_objects_plugin_impl::prepare_limit(const limit_order_object& limit_object)
@@ -339,8 +458,7 @@ void es_objects_plugin_impl::prepare_limit(const limit_order_object& limit_objec
    }
 
    prepare = graphene::utilities::createBulk(bulk_header, std::move(data));
-   std::move(prepare.begin(), prepare.end(), std::back_inserter(bulk));
-   prepare.clear();
+   add_to_bulk();
 }
 
 void es_objects_plugin_impl::prepare_bitasset(const asset_bitasset_data_object& bitasset_object)
@@ -365,8 +483,7 @@ void es_objects_plugin_impl::prepare_bitasset(const asset_bitasset_data_object&
       }
 
       prepare = graphene::utilities::createBulk(bulk_header, std::move(data));
-      std::move(prepare.begin(), prepare.end(), std::back_inserter(bulk));
-      prepare.clear();
+      add_to_bulk();
    }
 }
 
@@ -413,6 +530,8 @@ void es_objects_plugin::plugin_set_program_options(
          ("es-objects-asset-bitasset", boost::program_options::value<bool>(), "Store feed data(true)")
          ("es-objects-index-prefix", boost::program_options::value<std::string>(), "Add a prefix to the index(objects-)")
          ("es-objects-keep-only-current", boost::program_options::value<bool>(), "Keep only current state of the objects(true)")
+         ("es-objects-max-buffer-size", boost::program_options::value<uint64_t>(), "Send the bulk once its documents take this many bytes(268435456)")
+         ("es-objects-spill-dir", boost::program_options::value<std::string>(), "Directory to keep documents in while ES is behind, in memory if not set('')")
          ;
    cfg.add(cli);
 }
@@ -475,6 +594,13 @@ void es_objects_plugin::plugin_initialize(const boost::program_options::variable
    if (options.count("es-objects-keep-only-current")) {
       my->_es_objects_keep_only_current = options["es-objects-keep-only-current"].as<bool>();
    }
+   if (options.count("es-objects-max-buffer-size")) {
+      my->_es_objects_max_buffer_size = options["es-objects-max-buffer-size"].as<uint64_t>();
+   }
+   if (options.count("es-objects-spill-dir")) {
+      my->_es_objects_spill_dir = options["es-objects-spill-dir"].as<std::string>();
+   }
+   my->load_spilled();
 }
 
 void es_objects_plugin::plugin_startup()
@@ -73,13 +73,16 @@ public:
    virtual void plugin_shutdown() override;
 
 private:
+   fc::time_point next_production_wakeup()const;
    void schedule_production_loop();
    block_production_condition::block_production_condition_enum block_production_loop();
    block_production_condition::block_production_condition_enum maybe_produce_block( fc::limited_mutable_variant_object& capture );
+   void maybe_assemble_speculative_block();
 
    boost::program_options::variables_map _options;
    bool _production_enabled = false;
    bool _consecutive_production_enabled = false;
+   bool _speculative_assembly_enabled = false;
    uint32_t _required_witness_participation = 33 * GRAPHENE_1_PERCENT;
    uint32_t _production_skip_flags = graphene::chain::database::skip_nothing;
 
@@ -67,6 +67,7 @@ void witness_plugin::plugin_set_program_options(
    string witness_id_example = fc::json::to_string(chain::witness_id_type(5));
    command_line_options.add_options()
          ("enable-stale-production", bpo::bool_switch()->notifier([this](bool e){_production_enabled = e;}), "Enable block production, even if the chain is stale.")
+         ("speculative-block-assembly", bpo::bool_switch()->notifier([this](bool e){_speculative_assembly_enabled = e;}), "Assemble our next block from the pending state one tick ahead of the slot, so only signing and pushing remain at slot time.")
          ("required-participation", bpo::bool_switch()->notifier([this](int e){_required_witness_participation = uint32_t(e*GRAPHENE_1_PERCENT);}), "Percent of witnesses (0-99) that must be participating in order to produce blocks")
          ("witness-id,w", bpo::value<vector<string>>()->composing()->multitoken(),
           ("ID of witness controlled by this node (e.g. " + witness_id_example + ", quotes are required, may specify multiple times)").c_str())
@@ -141,7 +142,7 @@ void witness_plugin::plugin_shutdown()
    // nothing to do
 }
 
-void witness_plugin::schedule_production_loop()
+fc::time_point witness_plugin::next_production_wakeup()const
 {
    //Schedule for the next second's tick regardless of chain state
    // If we would wait less than 50ms, wait for the whole second.
@@ -150,10 +151,13 @@ void witness_plugin::schedule_production_loop()
    if( time_to_next_second < 50000 )      // we must sleep for at least 50ms
        time_to_next_second += 1000000;
 
-   fc::time_point next_wakeup( now + fc::microseconds( time_to_next_second ) );
+   return now + fc::microseconds( time_to_next_second );
+}
 
+void witness_plugin::schedule_production_loop()
+{
    _block_production_task = fc::schedule([this]{block_production_loop();},
-                                         next_wakeup, "Witness Block Production");
+                                         next_production_wakeup(), "Witness Block Production");
 }
 
 block_production_condition::block_production_condition_enum witness_plugin::block_production_loop()
@@ -204,10 +208,46 @@ block_production_condition::block_production_condition_enum witness_plugin::bloc
          break;
    }
 
+   if( _speculative_assembly_enabled )
+   {
+      try
+      {
+         maybe_assemble_speculative_block();
+      }
+      catch( const fc::canceled_exception& )
+      {
+         throw;
+      }
+      catch( const fc::exception& e )
+      {
+         // Not fatal, generate_block() will rebuild the block at slot time.
+         wlog("Got exception while assembling speculative block:\n${e}", ("e", e.to_detail_string()));
+      }
+   }
+
    schedule_production_loop();
    return result;
 }
 
+void witness_plugin::maybe_assemble_speculative_block()
+{
+   chain::database& db = database();
+   if( !_production_enabled )
+      return;
+
+   // Same slot computation as maybe_produce_block() will do on the next tick.
+   fc::time_point_sec when = next_production_wakeup() + fc::microseconds( 500000 );
+   uint32_t slot = db.get_slot_at_time( when );
+   if( slot == 0 )
+      return;
+
+   graphene::chain::witness_id_type scheduled_witness = db.get_scheduled_witness( slot );
+   if( _witnesses.find( scheduled_witness ) == _witnesses.end() )
+      return;
+
+   db.assemble_speculative_block( db.get_slot_time( slot ), scheduled_witness );
+}
+
 block_production_condition::block_production_condition_enum witness_plugin::maybe_produce_block( fc::limited_mutable_variant_object& capture )
 {
    chain::database& db = database();
@@ -291,6 +291,26 @@ struct operation_detail {
    operation_history_object op;
 };
 
+/**
+ * A single payment of @ref wallet_api::bulk_payout.
+ */
+struct bulk_payout_item {
+   string     type = "transfer";  ///< transfer or transfer_vault_to_wallet
+   string     from;
+   string     to;
+   string     amount;
+   string     asset_symbol;
+   string     memo;               ///< transfer only
+   share_type reserved = 0;       ///< transfer_vault_to_wallet only
+};
+
+struct bulk_payout_result {
+   uint32_t                      item = 0;  ///< position of the payment in the payout file
+   optional<transaction_id_type> transaction_id;
+   bool                          success = false;
+   string                        error;
+};
+
 /**
  * This wallet assumes it is connected to the database server with a high-bandwidth, low-latency connection and
  * performs minimal caching. This API could be provided locally to be used by a web interface.
@@ -836,6 +856,25 @@ class wallet_api
                                   share_type reserved_amount,
                                   bool broadcast = false);
 
+      /** Pay out a list of transfers and vault to wallet transfers.
+       *
+       * Payments are packed into as few transactions as the operation limit and the maximum transaction size
+       * allow, accounts and assets are looked up once for the whole list, transactions are signed on several
+       * threads and up to broadcast_window of them are broadcast at the same time.
+       *
+       * @param payouts_file a JSON array of bulk_payout_item, or a CSV file with one
+       *                     "type,from,to,amount,asset_symbol[,memo or reserved_amount]" line per payment
+       * @param max_operations_per_transaction maximum number of payments in a single transaction
+       * @param broadcast_window maximum number of transactions broadcast and waiting for the node's answer
+       * @param broadcast true to broadcast the transactions on the network
+       * @returns the result of every payment, in the order of the file. Payments of a transaction the node
+       *          rejected all report its error.
+       */
+      vector<bulk_payout_result> bulk_payout(string payouts_file,
+                                             uint32_t max_operations_per_transaction,
+                                             uint32_t broadcast_window,
+                                             bool broadcast = false);
+
       /**
        *  This method is used to convert a JSON transaction to its transactin ID.
        */
@@ -2416,6 +2455,12 @@ FC_REFLECT_DERIVED( graphene::wallet::vesting_balance_object_with_info, (graphen
 FC_REFLECT( graphene::wallet::operation_detail,
             (memo)(description)(op) )
 
+FC_REFLECT( graphene::wallet::bulk_payout_item,
+            (type)(from)(to)(amount)(asset_symbol)(memo)(reserved) )
+
+FC_REFLECT( graphene::wallet::bulk_payout_result,
+            (item)(transaction_id)(success)(error) )
+
 FC_API( graphene::wallet::wallet_api,
         (help)
         (gethelp)
@@ -2459,6 +2504,7 @@ FC_API( graphene::wallet::wallet_api,
         (transfer)
         (transfer2)
         (transfer_vault_to_wallet)
+        (bulk_payout)
         (get_transaction_id)
         (create_asset)
         (update_asset)
@@ -29,9 +29,13 @@
 #include <sstream>
 #include <string>
 #include <list>
+#include <deque>
+#include <fstream>
+#include <thread>
 
 #include <boost/version.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/replace.hpp>
 
 #include <boost/range/adaptor/map.hpp>
@@ -59,6 +63,7 @@
 #include <fc/crypto/hex.hpp>
 #include <fc/thread/mutex.hpp>
 #include <fc/thread/scoped_lock.hpp>
+#include <fc/thread/thread.hpp>
 
 #include <graphene/app/api.hpp>
 #include <graphene/chain/access_layer.hpp>
@@ -511,6 +516,12 @@ public:
          on_block_applied( block_id );
       } );
 
+      // The node reports changes of every object fetched by id, which keeps the object caches up to date
+      _remote_db->set_subscribe_callback( [this](const variant& updates )
+      {
+         on_objects_changed( updates );
+      }, false );
+
       _wallet.chain_id = _chain_id;
       _wallet.ws_server = initial_data.ws_server;
       _wallet.ws_user = initial_data.ws_user;
@@ -549,6 +560,32 @@ public:
       fc::async([this]{resync();}, "Resync after block");
    }
 
+   void on_objects_changed( const variant& updates )
+   {
+      if( !updates.is_array() )
+         return;
+      for( const variant& update : updates.get_array() )
+      {
+         // changed objects are sent in full, removed ones by id
+         object_id_type id;
+         if( update.is_object() && update.get_object().contains( "id" ) )
+            id = update.get_object()["id"].as<object_id_type>( 1 );
+         else if( update.is_string() )
+            id = update.as<object_id_type>( 1 );
+         else
+            continue;
+
+         if( id.is<account_object>() )
+            _account_cache.erase( id );
+         else if( id.is<asset_object>() )
+            _asset_cache.erase( id );
+         else if( id.is<license_type_object>() )
+            _license_type_cache.erase( id );
+         else if( id == object_id_type( global_property_id_type() ) )
+            _global_properties_cache.reset();
+      }
+   }
+
    bool copy_wallet_file( string destination_filename )
    {
       fc::path src_path = get_wallet_filename();
@@ -596,7 +633,7 @@ public:
 
    void set_operation_fees( signed_transaction& tx, const fee_schedule& s  )
    {
-      const auto& params = _remote_db->get_global_properties().parameters;
+      const auto& params = get_global_properties().parameters;
       fee_schedule& tmp_fee_schedule = const_cast<fee_schedule&>(s);
 
       for (const auto& ext : params.extensions)
@@ -667,17 +704,58 @@ public:
    }
    global_property_object get_global_properties() const
    {
-      return _remote_db->get_global_properties();
+      if( !_global_properties_cache )
+      {
+         // fetched as an object, so that the node reports its changes
+         auto props = _remote_db->get_objects( { object_id_type( global_property_id_type() ) } ).front();
+         _global_properties_cache = props.as<global_property_object>( GRAPHENE_MAX_NESTED_OBJECTS );
+      }
+      return *_global_properties_cache;
    }
    dynamic_global_property_object get_dynamic_global_properties() const
    {
       return _remote_db->get_dynamic_global_properties();
    }
+   vector<optional<account_object>> get_remote_accounts(const vector<account_id_type>& ids) const
+   {
+      vector<account_id_type> missing;
+      for( const auto id : ids )
+         if( !_account_cache.count(id) )
+            missing.push_back(id);
+      if( !missing.empty() )
+      {
+         auto recs = _remote_db->get_accounts(missing);
+         for( auto& rec : recs )
+            if( rec )
+               _account_cache[rec->id] = std::move(*rec);
+      }
+
+      vector<optional<account_object>> result;
+      result.reserve(ids.size());
+      for( const auto id : ids )
+      {
+         auto itr = _account_cache.find(id);
+         result.push_back( itr != _account_cache.end() ? itr->second : optional<account_object>() );
+      }
+      return result;
+   }
+   optional<account_object> find_remote_account(const string& name) const
+   {
+      auto itr = _account_ids_by_name.find(name);
+      if( itr == _account_ids_by_name.end() )
+      {
+         auto rec = _remote_db->lookup_account_names({name}).front();
+         if( !rec || rec->name != name )
+            return optional<account_object>();
+         itr = _account_ids_by_name.emplace(name, rec->id).first;
+      }
+      return get_remote_accounts({itr->second}).front();
+   }
    account_object get_account(account_id_type id) const
    {
       if( _wallet.my_accounts.get<by_id>().count(id) )
          return *_wallet.my_accounts.get<by_id>().find(id);
-      auto rec = _remote_db->get_accounts({id}).front();
+      auto rec = get_remote_accounts({id}).front();
       FC_ASSERT(rec);
       return *rec;
    }
@@ -694,7 +772,7 @@ public:
          if( _wallet.my_accounts.get<by_name>().count(account_name_or_id) )
          {
             auto local_account = *_wallet.my_accounts.get<by_name>().find(account_name_or_id);
-            auto blockchain_account = _remote_db->lookup_account_names({account_name_or_id}).front();
+            auto blockchain_account = find_remote_account(account_name_or_id);
             FC_ASSERT( blockchain_account );
             if (local_account.id != blockchain_account->id)
                elog("my account id ${id} different from blockchain id ${id2}", ("id", local_account.id)("id2", blockchain_account->id));
@@ -703,7 +781,7 @@ public:
 
             return *_wallet.my_accounts.get<by_name>().find(account_name_or_id);
          }
-         auto rec = _remote_db->lookup_account_names({account_name_or_id}).front();
+         auto rec = find_remote_account(account_name_or_id);
          FC_ASSERT( rec && rec->name == account_name_or_id );
          return *rec;
       }
@@ -715,6 +793,9 @@ public:
 
    optional<asset_object> find_asset(asset_id_type id)const
    {
+      auto itr = _asset_cache.find(id);
+      if( itr != _asset_cache.end() )
+         return itr->second;
       auto rec = _remote_db->get_assets({id}).front();
       if( rec )
          _asset_cache[id] = *rec;
@@ -731,13 +812,19 @@ public:
          return find_asset(*id);
       } else {
          // It's a symbol
+         auto itr = _asset_ids_by_symbol.find(asset_symbol_or_id);
+         if( itr != _asset_ids_by_symbol.end() )
+            return find_asset(itr->second);
+
          auto rec = _remote_db->lookup_asset_symbols({asset_symbol_or_id}).front();
          if( rec )
          {
             if( rec->symbol != asset_symbol_or_id )
                return optional<asset_object>();
 
-            _asset_cache[rec->get_id()] = *rec;
+            _asset_ids_by_symbol[asset_symbol_or_id] = rec->get_id();
+            // fetch it by id once, symbol lookups are not reported when the asset changes
+            return find_asset(rec->get_id());
          }
          return rec;
       }
@@ -764,23 +851,21 @@ public:
    asset_id_type get_asset_id(string asset_symbol_or_id) const
    {
       FC_ASSERT( asset_symbol_or_id.size() > 0 );
-      vector<optional<asset_object>> opt_asset;
       if( std::isdigit( asset_symbol_or_id.front() ) )
          return fc::variant(asset_symbol_or_id, 1).as<asset_id_type>( 1 );
-      opt_asset = _remote_db->lookup_asset_symbols( {asset_symbol_or_id} );
-      FC_ASSERT( (opt_asset.size() > 0) && (opt_asset[0].valid()) );
-      return opt_asset[0]->id;
+      auto opt_asset = find_asset( asset_symbol_or_id );
+      FC_ASSERT( opt_asset.valid() );
+      return opt_asset->id;
    }
 
    license_type_id_type get_license_type_id(string str_or_id) const
    {
       FC_ASSERT( str_or_id.size() > 0 );
-      vector<optional<license_type_object>> opt_license_type;
       if( std::isdigit( str_or_id.front() ) )
          return fc::variant(str_or_id, 1).as<license_type_id_type>( 1 );
-      opt_license_type = _remote_db->lookup_license_type_names( {str_or_id} );
-      FC_ASSERT( (opt_license_type.size() > 0) && (opt_license_type[0].valid()) );
-      return opt_license_type[0]->id;
+      auto opt_license_type = find_license_type( str_or_id );
+      FC_ASSERT( opt_license_type.valid() );
+      return opt_license_type->id;
    }
 
    string                            get_wallet_filename() const
@@ -973,7 +1058,7 @@ public:
       auto fee_asset_obj = get_asset(fee_asset);
       asset total_fee = fee_asset_obj.amount(0);
 
-      auto gprops = _remote_db->get_global_properties().parameters;
+      auto gprops = get_global_properties().parameters;
       if( fee_asset_obj.get_id() != asset_id_type() )
       {
          for( auto& op : _builder_transactions[handle].operations )
@@ -1026,7 +1111,7 @@ public:
       if( review_period_seconds )
          op.review_period_seconds = review_period_seconds;
       trx.operations = {op};
-      _remote_db->get_global_properties().parameters.current_fees->set_fee( trx.operations.front() );
+      get_global_properties().parameters.current_fees->set_fee( trx.operations.front() );
 
       return trx = sign_transaction(trx, broadcast);
    }
@@ -1047,7 +1132,7 @@ public:
       if( review_period_seconds )
          op.review_period_seconds = review_period_seconds;
       trx.operations = {op};
-      _remote_db->get_global_properties().parameters.current_fees->set_fee( trx.operations.front() );
+      get_global_properties().parameters.current_fees->set_fee( trx.operations.front() );
 
       return trx = sign_transaction(trx, broadcast);
    }
@@ -1081,7 +1166,7 @@ public:
 
       tx.operations.push_back( account_create_op );
 
-      auto current_fees = _remote_db->get_global_properties().parameters.current_fees;
+      auto current_fees = get_global_properties().parameters.current_fees;
       set_operation_fees( tx, current_fees );
 
       vector<public_key_type> paying_keys = registrar_account_object.active.get_keys();
@@ -1122,7 +1207,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1141,7 +1226,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1160,7 +1245,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1177,7 +1262,7 @@ public:
 
      signed_transaction tx;
      tx.operations.push_back(op);
-     set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+     set_operation_fees( tx, get_global_properties().parameters.current_fees );
      tx.validate();
 
      return sign_transaction(tx, broadcast);
@@ -1198,7 +1283,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(rda_op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1218,7 +1303,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(urda_op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1237,7 +1322,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(reserve_op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1256,7 +1341,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(unreserve_op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1286,7 +1371,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1314,7 +1399,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1339,7 +1424,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1378,7 +1463,7 @@ public:
 
          signed_transaction tx;
          tx.operations.push_back(op);
-         set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+         set_operation_fees( tx, get_global_properties().parameters.current_fees );
          tx.validate();
 
          return sign_transaction(tx, broadcast);
@@ -1427,7 +1512,7 @@ public:
 
          signed_transaction tx;
          tx.operations.push_back(op);
-         set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+         set_operation_fees( tx, get_global_properties().parameters.current_fees );
          tx.validate();
 
          return sign_transaction(tx, broadcast);
@@ -1447,7 +1532,7 @@ public:
 
          signed_transaction tx;
          tx.operations.push_back(op);
-         set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+         set_operation_fees( tx, get_global_properties().parameters.current_fees );
          tx.validate();
 
          return sign_transaction(tx, broadcast);
@@ -1471,7 +1556,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1491,7 +1576,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1517,7 +1602,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1537,7 +1622,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1565,7 +1650,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1584,7 +1669,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1603,7 +1688,7 @@ public:
 
        signed_transaction tx;
        tx.operations.push_back(op);
-       set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+       set_operation_fees( tx, get_global_properties().parameters.current_fees );
        tx.validate();
 
        return sign_transaction(tx, broadcast);
@@ -1623,7 +1708,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1649,7 +1734,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1672,7 +1757,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1691,7 +1776,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1712,7 +1797,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1736,7 +1821,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1758,7 +1843,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(tether_op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1780,7 +1865,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(transfer_op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1801,7 +1886,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(purchase_op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -1818,7 +1903,7 @@ public:
       op.account_to_upgrade = account_obj.get_id();
       op.upgrade_to_lifetime_member = true;
       tx.operations = {op};
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1904,7 +1989,7 @@ public:
 
          tx.operations.push_back( account_create_op );
 
-         set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+         set_operation_fees( tx, get_global_properties().parameters.current_fees);
 
          vector<public_key_type> paying_keys = registrar_account_object.active.get_keys();
 
@@ -1967,7 +2052,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( create_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -1996,7 +2081,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2017,7 +2102,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2041,7 +2126,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2063,7 +2148,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( publish_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2087,7 +2172,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( fund_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2107,7 +2192,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( claim_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2129,7 +2214,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( reserve_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2150,7 +2235,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( settle_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2171,7 +2256,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( settle_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2189,7 +2274,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( whitelist_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2207,7 +2292,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( committee_member_create_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2303,7 +2388,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( witness_create_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       _wallet.pending_witness_registrations[owner_account] = key_to_wif(witness_private_key);
@@ -2330,7 +2415,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( witness_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2381,7 +2466,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2446,7 +2531,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2504,7 +2589,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( vesting_balance_withdraw_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2539,7 +2624,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2573,7 +2658,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2604,7 +2689,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2630,7 +2715,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back( account_update_op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2659,7 +2744,7 @@ public:
       /// TODO: fetch the accounts specified via other_auths as well.
 
       vector< optional<account_object> > approving_account_objects =
-            _remote_db->get_accounts( v_approving_account_ids );
+            get_remote_accounts( v_approving_account_ids );
 
       /// TODO: recursively check one layer deeper in the authority tree for keys
 
@@ -2907,7 +2992,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -2928,7 +3013,7 @@ public:
 
       signed_transaction trx;
       trx.operations = {op};
-      set_operation_fees( trx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( trx, get_global_properties().parameters.current_fees);
       trx.validate();
       idump((broadcast));
 
@@ -2945,7 +3030,7 @@ public:
          op.fee_paying_account = get_object<limit_order_object>(order_id).seller;
          op.order = order_id;
          trx.operations = {op};
-         set_operation_fees( trx, _remote_db->get_global_properties().parameters.current_fees);
+         set_operation_fees( trx, get_global_properties().parameters.current_fees);
 
          trx.validate();
          return sign_transaction(trx, broadcast);
@@ -2980,7 +3065,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(xfer_op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -3007,12 +3092,291 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(xfer_op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees( tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction(tx, broadcast);
    } FC_CAPTURE_AND_RETHROW( (vault)(wallet)(amount)(asset_symbol)(reserved)(broadcast) ) }
 
+   vector<bulk_payout_item> read_bulk_payout_file(const string& payouts_file)
+   {
+      FC_ASSERT( fc::exists( payouts_file ), "Payout file ${f} does not exist", ("f", payouts_file) );
+
+      std::ifstream in( payouts_file );
+      const string content( (std::istreambuf_iterator<char>( in )), std::istreambuf_iterator<char>() );
+      const auto first = content.find_first_not_of( " \t\r\n" );
+      if( first != string::npos && content[first] == '[' )
+         return fc::json::from_string( content ).as<vector<bulk_payout_item>>( GRAPHENE_MAX_NESTED_OBJECTS );
+
+      vector<bulk_payout_item> items;
+      std::istringstream lines( content );
+      string line;
+      while( std::getline( lines, line ) )
+      {
+         boost::algorithm::trim( line );
+         if( line.empty() || line[0] == '#' )
+            continue;
+
+         vector<string> fields;
+         boost::algorithm::split( fields, line, boost::algorithm::is_any_of( "," ) );
+         for( auto& field : fields )
+            boost::algorithm::trim( field );
+         FC_ASSERT( fields.size() == 5 || fields.size() == 6, "Malformed payout line: ${l}", ("l", line) );
+
+         bulk_payout_item item;
+         item.type = fields[0];
+         item.from = fields[1];
+         item.to = fields[2];
+         item.amount = fields[3];
+         item.asset_symbol = fields[4];
+         if( fields.size() == 6 )
+         {
+            if( item.type == "transfer" )
+               item.memo = fields[5];
+            else
+               item.reserved = boost::lexical_cast<int64_t>( fields[5] );
+         }
+         items.push_back( std::move( item ) );
+      }
+      return items;
+   }
+
+   vector<bulk_payout_result> bulk_payout(string payouts_file, uint32_t max_operations_per_transaction,
+                                          uint32_t broadcast_window, bool broadcast)
+   { try {
+      FC_ASSERT( !self.is_locked() );
+      FC_ASSERT( max_operations_per_transaction > 0, "At least one operation per transaction is needed" );
+      FC_ASSERT( broadcast_window > 0, "At least one transaction has to be broadcast at a time" );
+
+      const auto items = read_bulk_payout_file( payouts_file );
+      vector<bulk_payout_result> results( items.size() );
+
+      // Accounts, assets and signing keys are looked up once for the whole file, not once per transaction
+      map<string, account_object> accounts;
+      map<account_id_type, const account_object*> accounts_by_id;
+      map<string, asset_object> assets;
+      const auto lookup_account = [&]( const string& name ) -> const account_object& {
+         auto it = accounts.find( name );
+         if( it == accounts.end() )
+         {
+            it = accounts.emplace( name, get_account( name ) ).first;
+            accounts_by_id[it->second.id] = &it->second;
+         }
+         return it->second;
+      };
+      const auto lookup_asset = [&]( const string& symbol ) -> const asset_object& {
+         auto it = assets.find( symbol );
+         if( it == assets.end() )
+            it = assets.emplace( symbol, get_asset( symbol ) ).first;
+         return it->second;
+      };
+
+      vector<optional<operation>> ops( items.size() );
+      for( size_t i = 0; i < items.size(); ++i )
+      {
+         results[i].item = i;
+         try
+         {
+            const auto& item = items[i];
+            const auto& asset_obj = lookup_asset( item.asset_symbol );
+            const auto& from = lookup_account( item.from );
+            const auto& to = lookup_account( item.to );
+            if( item.type == "transfer" )
+            {
+               transfer_operation xfer_op;
+               xfer_op.from = from.id;
+               xfer_op.to = to.id;
+               xfer_op.amount = asset_obj.amount_from_string( item.amount );
+               if( item.memo.size() )
+               {
+                  xfer_op.memo = memo_data();
+                  xfer_op.memo->from = from.options.memo_key;
+                  xfer_op.memo->to = to.options.memo_key;
+                  xfer_op.memo->set_message( get_private_key( from.options.memo_key ), to.options.memo_key, item.memo );
+               }
+               xfer_op.validate();
+               ops[i] = operation( xfer_op );
+            }
+            else if( item.type == "transfer_vault_to_wallet" )
+            {
+               transfer_vault_to_wallet_operation xfer_op;
+               xfer_op.from_vault = from.id;
+               xfer_op.to_wallet = to.id;
+               xfer_op.asset_to_transfer = asset_obj.amount_from_string( item.amount );
+               xfer_op.reserved_to_transfer = item.reserved;
+               xfer_op.validate();
+               ops[i] = operation( xfer_op );
+            }
+            else
+               FC_THROW( "Unknown payout type ${t}", ("t", item.type) );
+         }
+         catch( const fc::exception& e )
+         {
+            results[i].error = e.to_string();
+         }
+      }
+
+      // Pack the payments into transactions, leaving room for a signature per operation
+      const auto props = get_global_properties();
+      const auto dyn_props = get_dynamic_global_properties();
+      const size_t signature_size = fc::raw::pack_size( signature_type() );
+
+      struct payout_transaction
+      {
+         signed_transaction            tx;
+         vector<size_t>                items;
+         vector<fc::ecc::private_key>  keys;
+      };
+      vector<payout_transaction> trxs;
+      size_t tx_size = 0;
+      for( size_t i = 0; i < items.size(); ++i )
+      {
+         if( !ops[i].valid() )
+            continue;
+         const size_t op_size = fc::raw::pack_size( *ops[i] ) + signature_size;
+         if( trxs.empty() || trxs.back().items.size() >= max_operations_per_transaction ||
+             tx_size + op_size > props.parameters.maximum_transaction_size )
+         {
+            trxs.emplace_back();
+            tx_size = fc::raw::pack_size( signed_transaction() ) + signature_size;
+         }
+         trxs.back().tx.operations.push_back( *ops[i] );
+         trxs.back().items.push_back( i );
+         tx_size += op_size;
+      }
+
+      // The wallet's keys in each account's active authority, and the private key for each of them
+      map<account_id_type, vector<public_key_type>> account_keys;
+      map<public_key_type, fc::ecc::private_key> private_keys;
+      const auto keys_of = [&]( account_id_type id ) -> const vector<public_key_type>& {
+         auto it = account_keys.find( id );
+         if( it != account_keys.end() )
+            return it->second;
+         auto& keys = account_keys[id];
+         const auto acct = accounts_by_id.find( id );
+         if( acct == accounts_by_id.end() )
+            return keys;
+         for( const public_key_type& key : acct->second->active.get_keys() )
+         {
+            auto wif = _keys.find( key );
+            if( wif == _keys.end() )
+               continue;
+            if( private_keys.find( key ) == private_keys.end() )
+            {
+               fc::optional<fc::ecc::private_key> privkey = wif_to_key( wif->second );
+               FC_ASSERT( privkey.valid(), "Malformed private key in _keys" );
+               private_keys.emplace( key, *privkey );
+            }
+            keys.push_back( key );
+         }
+         return keys;
+      };
+
+      // Long lists take a while to broadcast, so use the longest expiration the chain accepts
+      const auto expiration = dyn_props.time + fc::seconds( props.parameters.maximum_time_until_expiration );
+      std::set<transaction_id_type> ids;
+      for( auto& trx : trxs )
+      {
+         try
+         {
+            set_operation_fees( trx.tx, props.parameters.current_fees );
+            trx.tx.set_reference_block( dyn_props.head_block_id );
+            trx.tx.validate();
+
+            // identical payments would otherwise make identical transactions
+            uint32_t expiration_time_offset = 0;
+            do
+               trx.tx.set_expiration( expiration - fc::seconds( expiration_time_offset++ ) );
+            while( !ids.insert( trx.tx.id() ).second ||
+                   _recently_generated_transactions.find( trx.tx.id() ) != _recently_generated_transactions.end() );
+            _recently_generated_transactions.insert( recently_generated_transaction_record( dyn_props.time, trx.tx.id() ) );
+
+            flat_set<account_id_type> active;
+            flat_set<account_id_type> owner;
+            vector<authority> other;
+            trx.tx.get_required_authorities( active, owner, other );
+            // Payers sharing a key must not sign twice with it, the chain rejects duplicate signatures
+            flat_set<public_key_type> approving_keys;
+            for( const auto id : active )
+            {
+               const auto& keys = keys_of( id );
+               approving_keys.insert( keys.begin(), keys.end() );
+            }
+            for( const public_key_type& key : approving_keys )
+               trx.keys.push_back( private_keys.at( key ) );
+         }
+         catch( const fc::exception& e )
+         {
+            for( auto i : trx.items )
+               results[i].error = e.to_string();
+            trx.items.clear();
+         }
+      }
+
+      // Signing is pure computation, spread it over a few threads
+      const size_t num_threads = std::min<size_t>( { std::max( 1u, std::thread::hardware_concurrency() ), size_t(8), trxs.size() } );
+      vector<std::shared_ptr<fc::thread>> sign_threads;
+      vector<fc::future<void>> signing;
+      for( size_t t = 0; t < num_threads; ++t )
+      {
+         sign_threads.push_back( std::make_shared<fc::thread>( "bulk_payout_sign_" + fc::to_string( t ) ) );
+         signing.push_back( sign_threads.back()->async( [&trxs, t, num_threads, this]() {
+            for( size_t i = t; i < trxs.size(); i += num_threads )
+               for( const auto& key : trxs[i].keys )
+                  trxs[i].tx.sign( key, _chain_id );
+         }, "bulk_payout_sign" ) );
+      }
+      for( auto& f : signing )
+         f.wait();
+      sign_threads.clear();
+
+      for( const auto& trx : trxs )
+         for( auto i : trx.items )
+         {
+            results[i].transaction_id = trx.tx.id();
+            results[i].success = !broadcast;
+         }
+
+      if( broadcast )
+      {
+         // Keep up to broadcast_window transactions waiting for the node's answer
+         std::deque<std::pair<size_t, fc::future<void>>> in_flight;
+         const auto finish = [&]() {
+            auto& sent = in_flight.front();
+            string error;
+            try
+            {
+               sent.second.wait();
+            }
+            catch( const fc::exception& e )
+            {
+               error = e.to_string();
+               elog( "Caught exception while broadcasting tx ${id}:  ${e}", ("id", trxs[sent.first].tx.id().str())("e", e.to_detail_string()) );
+            }
+            for( auto i : trxs[sent.first].items )
+            {
+               results[i].success = error.empty();
+               results[i].error = error;
+            }
+            in_flight.pop_front();
+         };
+         for( size_t t = 0; t < trxs.size(); ++t )
+         {
+            if( trxs[t].items.empty() )
+               continue;
+            if( in_flight.size() >= broadcast_window )
+               finish();
+            in_flight.emplace_back( t, fc::async( [this, &trxs, t]() {
+               _remote_net_broadcast->broadcast_transaction( trxs[t].tx );
+            }, "bulk_payout_broadcast" ) );
+         }
+         while( !in_flight.empty() )
+            finish();
+      }
+
+      return results;
+   } FC_CAPTURE_AND_RETHROW( (payouts_file)(max_operations_per_transaction)(broadcast_window)(broadcast) ) }
+
    signed_transaction issue_asset(string to_account, string amount, string symbol,
                                   string memo, bool broadcast = false)
    {
@@ -3037,7 +3401,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(issue_op);
-      set_operation_fees(tx,_remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees(tx,get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -3061,7 +3425,7 @@ public:
 
        signed_transaction tx;
        tx.operations.push_back(issue_op);
-       set_operation_fees(tx,_remote_db->get_global_properties().parameters.current_fees);
+       set_operation_fees(tx,get_global_properties().parameters.current_fees);
        tx.validate();
 
        return sign_transaction(tx, broadcast);
@@ -3444,7 +3808,13 @@ public:
 
    optional<license_type_object> find_license_type(license_type_id_type id)const
    {
-      return _remote_db->get_license_type(id);
+      auto itr = _license_type_cache.find(id);
+      if( itr != _license_type_cache.end() )
+         return itr->second;
+      auto rec = _remote_db->get_license_types({id}).front();
+      if( rec )
+         _license_type_cache[id] = *rec;
+      return rec;
    }
 
    optional<license_type_object> find_license_type(string str_or_id)const
@@ -3457,13 +3827,18 @@ public:
          return find_license_type(*id);
       } else {
          // It's a name
+         auto itr = _license_type_ids_by_name.find(str_or_id);
+         if( itr != _license_type_ids_by_name.end() )
+            return find_license_type(itr->second);
+
          auto rec = _remote_db->lookup_license_type_names({str_or_id}).front();
          if( rec )
          {
             if( rec->name != str_or_id )
                return optional<license_type_object>();
 
-            _license_type_cache[rec->id] = *rec;
+            _license_type_ids_by_name[str_or_id] = rec->id;
+            return find_license_type(rec->id);
          }
          return rec;
       }
@@ -3514,7 +3889,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -3541,7 +3916,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
 
       return sign_transaction( tx, broadcast );
@@ -3552,14 +3927,14 @@ public:
        optional<uint32_t> reward_interval_time_seconds,
        optional<share_type> dascoin_reward_amount, bool broadcast) {
      
-     auto issuer_id = _remote_db->get_global_properties().authorities.license_issuer;
+     auto issuer_id = get_global_properties().authorities.license_issuer;
 
      signed_transaction tx;
      tx.operations.push_back(update_queue_parameters_operation(
          issuer_id, enable_dascoin_queue, reward_interval_time_seconds,
          dascoin_reward_amount));
      set_operation_fees(
-         tx, _remote_db->get_global_properties().parameters.current_fees);
+         tx, get_global_properties().parameters.current_fees);
      tx.validate();
 
      return sign_transaction(tx, broadcast);
@@ -3575,7 +3950,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees(tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees(tx, get_global_properties().parameters.current_fees);
 
       return sign_transaction(tx, broadcast);
    }
@@ -3594,7 +3969,7 @@ public:
 
      signed_transaction tx;
      tx.operations.push_back(op);
-     set_operation_fees(tx, _remote_db->get_global_properties().parameters.current_fees);
+     set_operation_fees(tx, get_global_properties().parameters.current_fees);
 
      return sign_transaction(tx, broadcast);
    }
@@ -3607,7 +3982,7 @@ public:
      op.roll_back_enabled = roll_back_enabled;
      signed_transaction tx;
      tx.operations.push_back(op);
-     set_operation_fees(tx, _remote_db->get_global_properties().parameters.current_fees);
+     set_operation_fees(tx, get_global_properties().parameters.current_fees);
      return sign_transaction(tx, broadcast);
    }
 
@@ -3618,7 +3993,7 @@ public:
      op.account = get_account(account_name).id;
      signed_transaction tx;
      tx.operations.push_back(op);
-     set_operation_fees(tx, _remote_db->get_global_properties().parameters.current_fees);
+     set_operation_fees(tx, get_global_properties().parameters.current_fees);
      return sign_transaction(tx, broadcast);
    }
 
@@ -3635,7 +4010,7 @@ public:
 
       signed_transaction tx;
       tx.operations.push_back(op);
-      set_operation_fees(tx, _remote_db->get_global_properties().parameters.current_fees);
+      set_operation_fees(tx, get_global_properties().parameters.current_fees);
       tx.validate();
 
       return sign_transaction(tx, broadcast);
@@ -3831,8 +4206,15 @@ public:
 #endif
    const string _wallet_filename_extension = ".wallet";
 
+   // Objects fetched from the node, dropped when the node reports a change of them, see on_objects_changed()
+   mutable map<account_id_type, account_object> _account_cache;
    mutable map<asset_id_type, asset_object> _asset_cache;
    mutable map<license_type_id_type, license_type_object> _license_type_cache;
+   mutable optional<global_property_object> _global_properties_cache;
+   // Names and symbols never change, so their ids are kept for good
+   mutable map<string, account_id_type> _account_ids_by_name;
+   mutable map<string, asset_id_type> _asset_ids_by_symbol;
+   mutable map<string, license_type_id_type> _license_type_ids_by_name;
 };
 
 
@@ -4627,6 +5009,12 @@ signed_transaction wallet_api::transfer_vault_to_wallet(string vault, string wal
    return my->transfer_vault_to_wallet(vault, wallet, amount, asset_symbol, reserved, broadcast);
 }
 
+vector<bulk_payout_result> wallet_api::bulk_payout(string payouts_file, uint32_t max_operations_per_transaction,
+                                                   uint32_t broadcast_window, bool broadcast /* = false */)
+{
+   return my->bulk_payout(payouts_file, max_operations_per_transaction, broadcast_window, broadcast);
+}
+
 signed_transaction wallet_api::create_asset(string issuer,
                                             string symbol,
                                             uint8_t precision,
@@ -4978,6 +5366,15 @@ string wallet_api::gethelp(const string& method)const
       ss << "example: transfer vault-cli wallet-cli 1000 1.3.1 0 true\n";
       ss << "example: transfer 1.2.30 1.2.31 1000.123 1.3.2 0 true\n";
    }
+   else if( method == "bulk_payout" )
+   {
+      ss << "usage: bulk_payout PAYOUTS_FILE MAX_OPERATIONS_PER_TRANSACTION BROADCAST_WINDOW BROADCAST\n\n";
+      ss << "example: bulk_payout payroll.csv 50 20 true\n";
+      ss << "\n";
+      ss << "PAYOUTS_FILE is either a JSON array of {type, from, to, amount, asset_symbol, memo, reserved} objects or a\n";
+      ss << "CSV file with one \"type,from,to,amount,asset_symbol[,memo or reserved_amount]\" line per payment, where type\n";
+      ss << "is transfer or transfer_vault_to_wallet. Lines starting with # are ignored.\n";
+   }
    else if( method == "create_account_with_brain_key" )
    {
       ss << "usage: create_account_with_brain_key BRAIN_KEY ACCOUNT_NAME REGISTRAR REFERRER BROADCAST\n\n";
@@ -5217,7 +5614,7 @@ vector< signed_transaction > wallet_api_impl::import_balance( string name_or_id,
       tx.operations.reserve( ctx.ops.size() );
       for( const balance_claim_operation& op : ctx.ops )
          tx.operations.emplace_back( op );
-      set_operation_fees( tx, _remote_db->get_global_properties().parameters.current_fees );
+      set_operation_fees( tx, get_global_properties().parameters.current_fees );
       tx.validate();
       signed_transaction signed_tx = sign_transaction( tx, false );
       for( const address& addr : ctx.addrs )
@@ -5424,7 +5821,7 @@ blind_confirmation wallet_api::transfer_from_blind( string from_blind_account_ke
    transfer_from_blind_operation from_blind;
 
 
-   auto fees  = my->_remote_db->get_global_properties().parameters.current_fees;
+   auto fees  = my->get_global_properties().parameters.current_fees;
    fc::optional<asset_object> asset_obj = get_asset(symbol);
    FC_ASSERT(asset_obj.valid(), "Could not find asset matching ${asset}", ("asset", symbol));
    auto amount = asset_obj->amount_from_string(amount_in);
@@ -5502,7 +5899,7 @@ blind_confirmation wallet_api::blind_transfer_help( string from_key_or_label,
    blind_transfer_operation blind_tr;
    blind_tr.outputs.resize(2);
 
-   auto fees  = my->_remote_db->get_global_properties().parameters.current_fees;
+   auto fees  = my->get_global_properties().parameters.current_fees;
 
    auto amount = asset_obj->amount_from_string(amount_in);
 
@@ -5723,7 +6120,7 @@ blind_confirmation wallet_api::transfer_to_blind( string from_account_id_or_name
               [&]( const blind_output& a, const blind_output& b ){ return a.commitment < b.commitment; } );
 
    confirm.trx.operations.push_back( bop );
-   my->set_operation_fees( confirm.trx, my->_remote_db->get_global_properties().parameters.current_fees);
+   my->set_operation_fees( confirm.trx, my->get_global_properties().parameters.current_fees);
    confirm.trx.validate();
    confirm.trx = sign_transaction(confirm.trx, broadcast);
 
@@ -600,3 +600,57 @@ BOOST_AUTO_TEST_CASE( account_history_pagination )
    app1->shutdown();
 
 }
+
+///////////////////
+// Start a server and connect using the same calls as the CLI
+// Change the keys of an account the wallet has cached, and make sure
+// the node's change notification drops the cached copy
+///////////////////
+BOOST_AUTO_TEST_CASE( cli_account_cache_invalidation )
+{
+   using namespace graphene::chain;
+   using namespace graphene::app;
+   std::shared_ptr<graphene::app::application> app1;
+   try {
+      fc::temp_directory app_dir( graphene::utilities::temp_directory_path() );
+
+      int server_port_number = 0;
+      app1 = start_application(app_dir, server_port_number);
+
+      // connect to the server
+      client_connection con(app1, app_dir, server_port_number);
+
+      // init1 is not a wallet account, so the wallet fetches it by id and caches it
+      account_object init1_before = con.wallet_api_ptr->get_account("init1");
+
+      // replace its active key on chain, without going through the wallet
+      BOOST_TEST_MESSAGE("Changing init1's active key");
+      const public_key_type new_key = fc::ecc::private_key::regenerate(fc::sha256::hash(string("init1-new-active"))).get_public_key();
+      BOOST_REQUIRE(!init1_before.active.key_auths.count(new_key));
+      auto db = app1->chain_database();
+      account_update_operation update_op;
+      update_op.account = init1_before.id;
+      update_op.active = authority(1, new_key, 1);
+      signed_transaction update_tx;
+      update_tx.operations.push_back(update_op);
+      update_tx.set_expiration(db->head_block_time() + fc::minutes(1));
+      update_tx.set_reference_block(db->head_block_id());
+      db->push_transaction(update_tx, ~0);
+      BOOST_CHECK(generate_block(app1));
+
+      // the change notification reaches the wallet asynchronously
+      account_object init1_after = con.wallet_api_ptr->get_account("init1");
+      for( int i = 0; i < 50 && !init1_after.active.key_auths.count(new_key); ++i )
+      {
+         fc::usleep(fc::milliseconds(100));
+         init1_after = con.wallet_api_ptr->get_account("init1");
+      }
+      BOOST_CHECK(init1_after.active.key_auths.count(new_key));
+      BOOST_CHECK(init1_after.active == *update_op.active);
+
+   } catch( fc::exception& e ) {
+      edump((e.to_detail_string()));
+      throw;
+   }
+   app1->shutdown();
+}
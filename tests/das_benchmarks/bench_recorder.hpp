@@ -0,0 +1,125 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include <fc/io/json.hpp>
+#include <fc/time.hpp>
+#include <fc/variant_object.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace graphene { namespace chain { namespace test {
+
+/**
+ * Returns base multiplied by the DAS_BENCH_SCALE environment variable (1 if not set), so the same benchmarks can be
+ * run quickly on a laptop and at production-like sizes on a dedicated machine.
+ */
+inline uint32_t bench_size( uint32_t base )
+{
+   const char* scale_str = getenv("DAS_BENCH_SCALE");
+   const uint32_t scale = scale_str != nullptr ? std::max<uint32_t>( std::stoul( scale_str ), 1 ) : 1;
+   return base * scale;
+}
+
+/**
+ * Collects per-iteration latencies of a single benchmark and emits them as one line of JSON:
+ * { "benchmark": ..., "iterations": ..., "total_us": ..., "ops_per_sec": ..., "min_us": ..., "p50_us": ...,
+ *   "p90_us": ..., "p99_us": ..., "max_us": ..., <parameters> }
+ *
+ * Results are appended to the file named by the DAS_BENCH_RESULTS environment variable, or printed to stdout if it is
+ * not set. Each run appends a line per benchmark, so results of several runs can be compared with standard tools.
+ */
+class bench_recorder
+{
+public:
+   explicit bench_recorder( std::string name ) : _name( std::move(name) ) {}
+
+   /// Runs f once and records its duration as a single iteration.
+   template<typename Lambda>
+   void measure( Lambda&& f )
+   {
+      const auto start = fc::time_point::now();
+      f();
+      record( (fc::time_point::now() - start).count() );
+   }
+
+   /// Records an iteration timed by the caller, for loops where only some of the timed steps are of interest.
+   void record( int64_t elapsed_us ) { _samples.push_back( elapsed_us ); }
+
+   /// Attaches a parameter (queue size, number of accounts...) to the emitted result.
+   void set( const std::string& key, const fc::variant& value ) { _params( key, value ); }
+
+   size_t iterations() const { return _samples.size(); }
+
+   void write() const
+   {
+      auto sorted = _samples;
+      std::sort( sorted.begin(), sorted.end() );
+
+      int64_t total = 0;
+      for( const auto s : sorted )
+         total += s;
+
+      const auto percentile = [&sorted]( double p ) -> int64_t {
+         if( sorted.empty() )
+            return 0;
+         return sorted[ std::min<size_t>( sorted.size() - 1, static_cast<size_t>( p * sorted.size() ) ) ];
+      };
+
+      fc::mutable_variant_object result;
+      result( "benchmark", _name )
+            ( "iterations", sorted.size() )
+            ( "total_us", total )
+            ( "ops_per_sec", total > 0 ? sorted.size() * 1000000.0 / total : 0.0 )
+            ( "min_us", sorted.empty() ? 0 : sorted.front() )
+            ( "p50_us", percentile( 0.50 ) )
+            ( "p90_us", percentile( 0.90 ) )
+            ( "p99_us", percentile( 0.99 ) )
+            ( "max_us", sorted.empty() ? 0 : sorted.back() );
+      for( const auto& param : _params )
+         result( param.key(), param.value() );
+
+      const auto line = fc::json::to_string( fc::variant( result ) );
+      const char* results_file = getenv("DAS_BENCH_RESULTS");
+      if( results_file != nullptr )
+      {
+         std::ofstream out( results_file, std::ios::app );
+         out << line << std::endl;
+      }
+      else
+         std::cout << line << std::endl;
+   }
+
+private:
+   std::string _name;
+   std::vector<int64_t> _samples;
+   fc::mutable_variant_object _params;
+};
+
+} } } // graphene::chain::test
@@ -0,0 +1,107 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/das33_object.hpp>
+
+#include "das_bench_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( das_benchmarks, das_bench_fixture )
+
+BOOST_AUTO_TEST_SUITE( das33_benchmarks )
+
+BOOST_AUTO_TEST_CASE( das33_pledge_and_distribute_benchmark )
+{ try {
+  ACTOR(owner);
+  const uint32_t num_users = bench_size(20);
+  const uint32_t pledges_per_user = 10;
+  const auto funder_id = create_funded_wallet("das33-funder", num_users * (pledges_per_user + 1));
+  const auto users = create_bench_accounts("das33-user", num_users);
+
+  for ( const auto& user_id : users )
+    transfer(funder_id, user_id, asset{(pledges_per_user + 1) * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()});
+  generate_block();
+
+  asset_id_type test_asset_id = create_new_asset("BENCH", 10000000000, 2, price{asset(1),asset(1,asset_id_type(1))});
+
+  das33_project_create_operation project_create;
+      project_create.authority       = get_das33_administrator_id();
+      project_create.name            = "bench_project";
+      project_create.owner           = owner_id;
+      project_create.token           = test_asset_id;
+      project_create.discounts       = {{get_dascoin_asset_id(), 50}};
+      project_create.goal_amount_eur = 10000000;
+      project_create.min_pledge      = 0;
+      project_create.max_pledge      = 10000000;
+  do_op(project_create);
+
+  das33_project_object project = get_das33_projects()[0];
+
+  das33_project_update_operation project_update;
+      project_update.project_id = project.id;
+      project_update.authority  = get_das33_administrator_id();
+      project_update.status     = das33_project_status::active;
+  do_op(project_update);
+
+  bench_recorder pledge("das33_pledge");
+  uint32_t pushed = 0;
+  for ( uint32_t round = 0; round < pledges_per_user; ++round )
+    for ( const auto& user_id : users )
+    {
+      // Amounts differ by round so pledges of the same user in one block are not duplicate transactions:
+      const das33_pledge_asset_operation op(user_id, asset{1 * DASCOIN_DEFAULT_ASSET_PRECISION + round, get_dascoin_asset_id()}, optional<license_type_id_type>{}, project.id);
+      pledge.measure([&]{ push_op_no_balance_check(op, false); });
+      if ( ++pushed % setup_batch_size == 0 )
+        generate_block();
+    }
+  generate_block();
+
+  const uint32_t num_pledges = num_users * pledges_per_user;
+  BOOST_CHECK_EQUAL( get_das33_pledges().size(), num_pledges );
+
+  // The whole phase is distributed by a single operation, so its latency grows with the number of pledges:
+  bench_recorder distribute("das33_distribute_project_pledges");
+  const das33_distribute_project_pledges_operation distribute_op(get_das33_administrator_id(), project.id, 0, 10000, 10000, 10000);
+  distribute.measure([&]{ push_op_no_balance_check(distribute_op, false); });
+  bench_recorder distribute_block("das33_distribute_project_pledges_block");
+  distribute_block.record(timed_generate_block());
+
+  BOOST_CHECK_EQUAL( get_das33_pledges().size(), 0 );
+
+  pledge.set("users", num_users);
+  pledge.write();
+  distribute.set("pledges", num_pledges);
+  distribute.write();
+  distribute_block.set("pledges", num_pledges);
+  distribute_block.write();
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,82 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#pragma once
+
+#include "../common/database_fixture.hpp"
+#include "bench_recorder.hpp"
+
+namespace graphene { namespace chain {
+
+/**
+ * database_fixture extended with the bulk setup steps shared by the DasCoin benchmarks. Setup is never measured, only
+ * the operations and blocks passed to a bench_recorder are.
+ */
+struct das_bench_fixture : public database_fixture
+{
+   /// Creates count wallet (or vault) accounts named <prefix>-<n>, generating a block every setup_batch_size accounts.
+   vector<account_id_type> create_bench_accounts(const string& prefix, uint32_t count, bool vaults = false)
+   {
+      vector<account_id_type> result;
+      result.reserve(count);
+      for ( uint32_t i = 0; i < count; ++i )
+      {
+         const string name = prefix + "-" + fc::to_string(i);
+         const auto key = public_key_type(generate_private_key(name).get_public_key());
+         result.push_back(vaults ? create_new_vault_account(get_registrar_id(), name, key).id
+                                 : create_new_account(get_registrar_id(), name, key).id);
+         if ( (i + 1) % setup_batch_size == 0 )
+            generate_block();
+      }
+      generate_block();
+      return result;
+   }
+
+   /// Creates a wallet holding amount dascoin minted through its tethered vault.
+   account_id_type create_funded_wallet(const string& name, share_type amount)
+   {
+      const auto& wallet = create_new_account(get_registrar_id(), name, public_key_type(generate_private_key(name).get_public_key()));
+      const auto& vault = create_new_vault_account(get_registrar_id(), name + "-vault", public_key_type(generate_private_key(name + "-vault").get_public_key()));
+      const account_id_type wallet_id = wallet.id;
+      const account_id_type vault_id = vault.id;
+
+      tether_accounts(wallet_id, vault_id);
+      issue_dascoin(vault_id, amount);
+      disable_vault_to_wallet_limit(vault_id);
+      transfer_dascoin_vault_to_wallet(vault_id, wallet_id, amount * DASCOIN_DEFAULT_ASSET_PRECISION);
+      generate_block();
+      return wallet_id;
+   }
+
+   /// Generates a single block and returns how long it took, in microseconds.
+   int64_t timed_generate_block()
+   {
+      const auto start = fc::time_point::now();
+      generate_block();
+      return (fc::time_point::now() - start).count();
+   }
+
+   static const uint32_t setup_batch_size = 100;
+};
+
+} } // graphene::chain
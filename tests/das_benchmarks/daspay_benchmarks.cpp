@@ -0,0 +1,122 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/daspay_object.hpp>
+
+#include "das_bench_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( das_benchmarks, das_bench_fixture )
+
+BOOST_AUTO_TEST_SUITE( daspay_benchmarks )
+
+BOOST_AUTO_TEST_CASE( daspay_debit_credit_benchmark )
+{ try {
+  ACTORS((clearing)(payment)(seller));
+  const uint32_t num_users = bench_size(200);
+  const auto funder_id = create_funded_wallet("daspay-funder", num_users * 110 + 100);
+  const auto users = create_bench_accounts("daspay-user", num_users);
+  const public_key_type pk = public_key_type(generate_private_key("daspay-bench").get_public_key());
+
+  do_op(create_payment_service_provider_operation(get_daspay_administrator_id(), payment_id, {clearing_id}));
+  do_op(set_daspay_transaction_ratio_operation(get_daspay_administrator_id(), 200, 200));
+  do_op(update_delayed_operations_resolver_parameters_operation(get_global_properties().authorities.root_administrator, true, 600));
+
+  // Set price to 1we -> 100dasc and put orders on both sides of the book:
+  set_last_dascoin_price(asset(100 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()) / asset(1 * DASCOIN_FIAT_ASSET_PRECISION, get_web_asset_id()));
+  issue_webasset("1", seller_id, 1 * DASCOIN_FIAT_ASSET_PRECISION, 0);
+  do_op(limit_order_create_operation(seller_id, asset{1 * DASCOIN_FIAT_ASSET_PRECISION, get_web_asset_id()}, asset{100 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()}, 0, {}));
+  do_op(limit_order_create_operation(funder_id, asset{50 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()}, asset{1 * DASCOIN_FIAT_ASSET_PRECISION, get_web_asset_id()}, 0, {}));
+
+  transfer(funder_id, clearing_id, asset{num_users * 10 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()});
+  for ( uint32_t i = 0; i < num_users; ++i )
+  {
+    transfer(funder_id, users[i], asset{100 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()});
+    push_op(reserve_asset_on_account_operation(users[i], asset{50 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()}), false);
+    push_op(register_daspay_authority_operation(users[i], payment_id, pk, {}), false);
+    if ( (i + 1) % setup_batch_size == 0 )
+      generate_block();
+  }
+  generate_block();
+
+  bench_recorder debit("daspay_debit");
+  bench_recorder credit("daspay_credit");
+  for ( uint32_t i = 0; i < num_users; ++i )
+  {
+    const daspay_debit_account_operation debit_op(payment_id, pk, users[i], asset{1, get_web_asset_id()}, clearing_id, fc::to_string(i), {});
+    const daspay_credit_account_operation credit_op(payment_id, users[i], asset{1, get_web_asset_id()}, clearing_id, fc::to_string(i), {});
+    debit.measure([&]{ push_op_no_balance_check(debit_op, false); });
+    credit.measure([&]{ push_op_no_balance_check(credit_op, false); });
+    if ( (i + 1) % setup_batch_size == 0 )
+      generate_block();
+  }
+  generate_block();
+
+  // Every user then unreserves, which is delayed until the resolver runs:
+  bench_recorder unreserve("daspay_unreserve");
+  for ( uint32_t i = 0; i < num_users; ++i )
+  {
+    const unreserve_asset_on_account_operation op(users[i], asset{10 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()});
+    unreserve.measure([&]{ push_op_no_balance_check(op, false); });
+    if ( (i + 1) % setup_batch_size == 0 )
+      generate_block();
+  }
+  generate_block();
+
+  const auto& delayed_idx = db.get_index_type<delayed_operations_index>().indices();
+  BOOST_CHECK_EQUAL( delayed_idx.size(), num_users );
+
+  // Time only the blocks in which the resolver runs:
+  bench_recorder resolve("daspay_delayed_operations_resolve_block");
+  const auto& dgpo = get_dynamic_global_properties();
+  const auto block_interval = get_chain_parameters().block_interval;
+  for ( uint32_t i = 0; i < 8 && !delayed_idx.empty(); ++i )
+  {
+    generate_blocks(dgpo.next_delayed_operations_resolver_time - block_interval);
+    const auto size_before = delayed_idx.size();
+    const auto elapsed = timed_generate_block();
+    if ( delayed_idx.size() < size_before )
+      resolve.record(elapsed);
+  }
+
+  BOOST_CHECK( delayed_idx.empty() );
+
+  debit.set("users", num_users);
+  debit.write();
+  credit.set("users", num_users);
+  credit.write();
+  unreserve.set("users", num_users);
+  unreserve.write();
+  resolve.set("delayed_operations", num_users);
+  resolve.write();
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,77 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/license_objects.hpp>
+
+#include "das_bench_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( das_benchmarks, das_bench_fixture )
+
+BOOST_AUTO_TEST_SUITE( license_benchmarks )
+
+BOOST_AUTO_TEST_CASE( license_issue_and_upgrade_benchmark )
+{ try {
+  const uint32_t num_vaults = bench_size(500);
+  const auto vaults = create_bench_accounts("license-vault", num_vaults, true);
+  const auto standard_locked = *(_dal.get_license_type("standard_locked"));
+  const time_point_sec activated_time = db.head_block_time();
+
+  bench_recorder issue("license_issue");
+  for ( uint32_t i = 0; i < num_vaults; ++i )
+  {
+    const issue_license_operation op(get_license_issuer_id(), vaults[i], standard_locked.id, 0, 100, activated_time);
+    issue.measure([&]{ push_op_no_balance_check(op, false); });
+    if ( (i + 1) % setup_batch_size == 0 )
+      generate_block();
+  }
+  generate_block();
+
+  const auto& dgpo = get_dynamic_global_properties();
+  const time_point_sec execution_time = dgpo.next_maintenance_time;
+  do_op(create_upgrade_event_operation(get_license_administrator_id(), execution_time, activated_time + fc::hours(72),
+                                       {}, "bench_upgrade"));
+
+  // The upgrade is executed during maintenance, so time the maintenance block alone:
+  bench_recorder upgrade("license_upgrade_maintenance_block");
+  generate_blocks(execution_time - get_chain_parameters().block_interval);
+  upgrade.record(timed_generate_block());
+
+  BOOST_CHECK_EQUAL( get_cycle_balance(vaults.front()).value, 2 * DASCOIN_BASE_STANDARD_CYCLES );
+  BOOST_CHECK_EQUAL( get_cycle_balance(vaults.back()).value, 2 * DASCOIN_BASE_STANDARD_CYCLES );
+
+  issue.set("vaults", num_vaults);
+  issue.write();
+  upgrade.set("upgraded_licenses", num_vaults);
+  upgrade.write();
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
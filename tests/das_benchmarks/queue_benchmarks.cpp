@@ -0,0 +1,115 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/queue_objects.hpp>
+
+#include "das_bench_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( das_benchmarks, das_bench_fixture )
+
+BOOST_AUTO_TEST_SUITE( queue_benchmarks )
+
+BOOST_AUTO_TEST_CASE( reward_queue_submission_benchmark )
+{ try {
+  const uint32_t num_vaults = bench_size(100);
+  const uint32_t num_submissions = bench_size(2000);
+  const auto vaults = create_bench_accounts("queue-vault", num_vaults, true);
+
+  bench_recorder submissions("reward_queue_submit");
+  bench_recorder blocks("reward_queue_submit_block");
+
+  for ( uint32_t i = 0; i < num_submissions; ++i )
+  {
+    // The comment keeps otherwise identical submissions in the same block from being duplicate transactions:
+    const submit_reserve_cycles_to_queue_operation op(get_cycle_issuer_id(), vaults[i % num_vaults], 200, 200, fc::to_string(i));
+    submissions.measure([&]{ push_op_no_balance_check(op, false); });
+    if ( (i + 1) % setup_batch_size == 0 )
+      blocks.record(timed_generate_block());
+  }
+  blocks.record(timed_generate_block());
+
+  BOOST_CHECK_EQUAL( _dal.get_reward_queue_size(), num_submissions );
+
+  submissions.set("vaults", num_vaults);
+  submissions.set("final_queue_size", num_submissions);
+  submissions.write();
+  blocks.set("ops_per_block", setup_batch_size);
+  blocks.write();
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( reward_queue_minting_benchmark )
+{ try {
+  const uint32_t num_vaults = bench_size(100);
+  const uint32_t queue_size = bench_size(5000);
+  const uint32_t minted_per_interval = bench_size(100);
+  const auto vaults = create_bench_accounts("mint-vault", num_vaults, true);
+
+  // Each submission is worth 100 dascoin, mint minted_per_interval of them on every reward interval:
+  adjust_dascoin_reward(minted_per_interval * 100 * DASCOIN_DEFAULT_ASSET_PRECISION);
+  adjust_frequency(200);
+
+  for ( uint32_t i = 0; i < queue_size; ++i )
+  {
+    push_op(submit_reserve_cycles_to_queue_operation(get_cycle_issuer_id(), vaults[i % num_vaults], 200, 200, fc::to_string(i)), false);
+    if ( (i + 1) % setup_batch_size == 0 )
+      generate_block();
+  }
+  generate_block();
+  BOOST_CHECK_EQUAL( _dal.get_reward_queue_size(), queue_size );
+
+  toggle_reward_queue(true);
+
+  bench_recorder minting("reward_queue_mint_block");
+  const auto& dgpo = get_dynamic_global_properties();
+  const auto block_interval = get_chain_parameters().block_interval;
+  const uint32_t max_intervals = queue_size / minted_per_interval + 2;
+
+  // Time only the blocks which actually mint, skipping the empty blocks in between:
+  for ( uint32_t i = 0; i < max_intervals && _dal.get_reward_queue_size() > 0; ++i )
+  {
+    generate_blocks(dgpo.next_dascoin_reward_time - block_interval);
+    const auto size_before = _dal.get_reward_queue_size();
+    const auto elapsed = timed_generate_block();
+    if ( _dal.get_reward_queue_size() < size_before )
+      minting.record(elapsed);
+  }
+
+  BOOST_CHECK_EQUAL( _dal.get_reward_queue_size(), 0 );
+
+  minting.set("vaults", num_vaults);
+  minting.set("initial_queue_size", queue_size);
+  minting.set("minted_per_interval", minted_per_interval);
+  minting.write();
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
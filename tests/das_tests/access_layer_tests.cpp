@@ -286,6 +286,65 @@ BOOST_AUTO_TEST_CASE( get_vaults_info_unit_test )
 
 } FC_LOG_AND_RETHROW () }
 
+BOOST_AUTO_TEST_CASE( get_vaults_info_page_unit_test )
+{ try {
+  ACTOR(wallet)
+  VAULT_ACTOR(vault1)
+  VAULT_ACTOR(vault2)
+  VAULT_ACTOR(vault3)
+
+  auto page = _dal.get_vaults_info_page(wallet_id, 2);
+
+  // The wallet is skipped, the third vault starts the next page:
+  BOOST_CHECK_EQUAL( page.vaults.size(), 2 );
+  BOOST_CHECK( page.vaults[0].account_id == vault1_id );
+  BOOST_CHECK( page.vaults[0].result.valid() );
+  BOOST_CHECK( page.vaults[1].account_id == vault2_id );
+  BOOST_REQUIRE( page.next.valid() );
+  BOOST_CHECK( *page.next == vault3_id );
+
+  page = _dal.get_vaults_info_page(*page.next, 2);
+  BOOST_CHECK_EQUAL( page.vaults.size(), 1 );
+  BOOST_CHECK( page.vaults[0].account_id == vault3_id );
+  BOOST_CHECK( !page.next.valid() );
+
+  GRAPHENE_REQUIRE_THROW( _dal.get_vaults_info_page(wallet_id, 1001), fc::exception );
+
+} FC_LOG_AND_RETHROW () }
+
+BOOST_AUTO_TEST_CASE( get_queue_submissions_with_pos_page_unit_test )
+{ try {
+  VAULT_ACTORS((first)(second)(third))
+
+  do_op(submit_reserve_cycles_to_queue_operation(get_cycle_issuer_id(), second_id, 200, 200, ""));
+  do_op(submit_reserve_cycles_to_queue_operation(get_cycle_issuer_id(), first_id, 100, 200, ""));
+  do_op(submit_reserve_cycles_to_queue_operation(get_cycle_issuer_id(), second_id, 210, 200, ""));
+  do_op(submit_reserve_cycles_to_queue_operation(get_cycle_issuer_id(), third_id, 300, 200, ""));
+
+  auto page = _dal.get_queue_submissions_with_pos_page(first_id, 2);
+
+  BOOST_CHECK_EQUAL( page.accounts.size(), 2 );
+  BOOST_CHECK( page.accounts[0].account_id == first_id );
+  BOOST_REQUIRE_EQUAL( page.accounts[0].result->size(), 1 );
+  BOOST_CHECK_EQUAL( (*page.accounts[0].result)[0].position, 1 );
+  BOOST_CHECK_EQUAL( (*page.accounts[0].result)[0].submission.amount.value, 100 );
+
+  BOOST_CHECK( page.accounts[1].account_id == second_id );
+  BOOST_REQUIRE_EQUAL( page.accounts[1].result->size(), 2 );
+  BOOST_CHECK_EQUAL( (*page.accounts[1].result)[0].position, 0 );
+  BOOST_CHECK_EQUAL( (*page.accounts[1].result)[1].position, 2 );
+
+  BOOST_REQUIRE( page.next.valid() );
+  BOOST_CHECK( *page.next == third_id );
+
+  page = _dal.get_queue_submissions_with_pos_page(*page.next, 2);
+  BOOST_CHECK_EQUAL( page.accounts.size(), 1 );
+  BOOST_CHECK( page.accounts[0].account_id == third_id );
+  BOOST_CHECK_EQUAL( (*page.accounts[0].result)[0].position, 3 );
+  BOOST_CHECK( !page.next.valid() );
+
+} FC_LOG_AND_RETHROW () }
+
 BOOST_AUTO_TEST_CASE( account_tethered_unit_test )
 { try {
   ACTOR(wallet);
@@ -261,5 +261,42 @@ BOOST_AUTO_TEST_CASE(update_global_parameters_test)
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( authority_verification_cache_test )
+{ try {
+  ACTORS((alice)(bob));
+  auto& cache = db.get_authority_verification_cache();
+  cache.clear();
+
+  const auto push_signed = [&](bool roll_back_enabled, const fc::ecc::private_key& key) {
+    signed_transaction tx;
+    tx.operations.push_back(set_roll_back_enabled_operation(alice_id, roll_back_enabled));
+    set_expiration(db, tx);
+    sign(tx, key);
+    PUSH_TX(db, tx, 0);
+  };
+
+  push_signed(false, alice_private_key);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+
+  BOOST_TEST_MESSAGE("Same keys for the same account are verified from the cache.");
+  push_signed(true, alice_private_key);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+
+  BOOST_TEST_MESSAGE("Changing the keys invalidates the cached result.");
+  do_op(change_public_keys_operation(alice_id, {authority(1, bob_public_key, 1)}, {authority(1, bob_public_key, 1)}));
+  generate_block();
+  GRAPHENE_REQUIRE_THROW(push_signed(false, alice_private_key), fc::exception);
+  push_signed(false, bob_private_key);
+
+  BOOST_TEST_MESSAGE("Authorities replaced without bumping the change counters are detected too.");
+  generate_block();
+  db.modify(alice_id(db), [&](account_object& a) {
+    a.active = authority(1, alice_public_key, 1);
+  });
+  GRAPHENE_REQUIRE_THROW(push_signed(true, bob_private_key), fc::exception);
+  push_signed(true, alice_private_key);
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()  // account_unit_tests
 BOOST_AUTO_TEST_SUITE_END()  // dascoin_tests
@@ -0,0 +1,262 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <boost/test/unit_test.hpp>
+#include <graphene/app/api_request_scheduler.hpp>
+
+#include <fc/thread/thread.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+using graphene::app::api_access_info;
+using graphene::app::api_request_scheduler;
+
+namespace {
+
+api_access_info make_access( uint32_t priority, uint32_t max_concurrent_requests = 4,
+                             uint32_t max_queued_requests = 64, uint32_t max_queue_time_ms = 5000 )
+{
+  api_access_info access;
+  access.priority = priority;
+  access.max_concurrent_requests = max_concurrent_requests;
+  access.max_queued_requests = max_queued_requests;
+  access.max_queue_time_ms = max_queue_time_ms;
+  return access;
+}
+
+/// Admits requests from tasks of this thread and keeps their tickets until released
+struct waiters
+{
+  api_request_scheduler& scheduler;
+  std::map<std::string, std::unique_ptr<api_request_scheduler::ticket>> tickets;
+  vector<std::string> admitted;
+
+  explicit waiters( api_request_scheduler& s ) : scheduler(s) {}
+
+  fc::future<void> wait( api_request_scheduler::connection_state& connection, const std::string& name,
+                         const std::string& method = "get_account_count" )
+  {
+    auto f = fc::async([this, &connection, name, method]() {
+      auto ticket = scheduler.admit(connection, method, fc::variants());
+      admitted.push_back(name);
+      tickets[name] = std::move(ticket);
+    }, "api_request_scheduler_test");
+    run_pending();
+    return f;
+  }
+
+  void release( const std::string& name )
+  {
+    tickets.erase(name);
+    run_pending();
+  }
+
+  static void run_pending()
+  {
+    fc::usleep(fc::milliseconds(10));
+  }
+};
+
+}
+
+BOOST_FIXTURE_TEST_SUITE( dascoin_tests, database_fixture )
+
+BOOST_FIXTURE_TEST_SUITE( api_request_scheduler_tests, database_fixture )
+
+BOOST_AUTO_TEST_CASE( admission_order_test )
+{ try {
+  api_request_scheduler scheduler(1, {});
+  auto busy = scheduler.open_connection(make_access(0));
+  auto low1 = scheduler.open_connection(make_access(0));
+  auto low2 = scheduler.open_connection(make_access(0));
+  auto high = scheduler.open_connection(make_access(1));
+  waiters w(scheduler);
+
+  BOOST_TEST_MESSAGE("Within the budget a request runs right away.");
+  auto blocker = scheduler.admit(*busy, "get_account_count", fc::variants());
+  BOOST_CHECK_EQUAL( scheduler.get_stats().cost_in_flight, 1 );
+
+  BOOST_TEST_MESSAGE("Requests of the same priority are admitted in order of arrival.");
+  auto f1 = w.wait(*low1, "low1");
+  auto f2 = w.wait(*low2, "low2");
+  BOOST_CHECK( w.admitted.empty() );
+  BOOST_CHECK_EQUAL( scheduler.get_stats().requests_queued, 2 );
+
+  BOOST_TEST_MESSAGE("A higher priority overtakes them.");
+  auto f3 = w.wait(*high, "high");
+  blocker.reset();
+  w.run_pending();
+  BOOST_CHECK( w.admitted == vector<std::string>({"high"}) );
+  w.release("high");
+  BOOST_CHECK( w.admitted == vector<std::string>({"high", "low1"}) );
+  w.release("low1");
+  BOOST_CHECK( w.admitted == vector<std::string>({"high", "low1", "low2"}) );
+  w.release("low2");
+  f1.wait(); f2.wait(); f3.wait();
+
+  const auto stats = scheduler.get_stats();
+  BOOST_CHECK_EQUAL( stats.cost_in_flight, 0 );
+  BOOST_CHECK_EQUAL( stats.requests_in_flight, 0 );
+  BOOST_CHECK_EQUAL( stats.requests_queued, 0 );
+  BOOST_CHECK_EQUAL( stats.methods.at("get_account_count").admitted, 4 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( connection_limit_test )
+{ try {
+  api_request_scheduler scheduler(10, {});
+  auto limited = scheduler.open_connection(make_access(1, 1));
+  auto other = scheduler.open_connection(make_access(0));
+  waiters w(scheduler);
+
+  BOOST_TEST_MESSAGE("A connection at its own limit waits, even with budget left.");
+  auto first = scheduler.admit(*limited, "get_account_count", fc::variants());
+  auto f1 = w.wait(*limited, "limited");
+  BOOST_CHECK( w.admitted.empty() );
+
+  BOOST_TEST_MESSAGE("Others are not held up behind it, despite its higher priority.");
+  auto f2 = w.wait(*other, "other");
+  BOOST_CHECK( w.admitted == vector<std::string>({"other"}) );
+
+  first.reset();
+  w.run_pending();
+  BOOST_CHECK( w.admitted == vector<std::string>({"other", "limited"}) );
+  w.release("other");
+  w.release("limited");
+  f1.wait(); f2.wait();
+  BOOST_CHECK_EQUAL( scheduler.get_stats().cost_in_flight, 0 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( oversize_request_test )
+{ try {
+  api_request_scheduler scheduler(10, {});
+  auto connection = scheduler.open_connection(make_access(0));
+  waiters w(scheduler);
+  BOOST_REQUIRE_GT( scheduler.estimate_cost("get_total_cycles", fc::variants()), 10 );
+
+  BOOST_TEST_MESSAGE("A request costing more than the whole budget waits until nothing else runs.");
+  auto small = scheduler.admit(*connection, "get_account_count", fc::variants());
+  auto f1 = w.wait(*connection, "big", "get_total_cycles");
+  BOOST_CHECK( w.admitted.empty() );
+  small.reset();
+  w.run_pending();
+  BOOST_CHECK( w.admitted == vector<std::string>({"big"}) );
+
+  BOOST_TEST_MESSAGE("And then runs alone.");
+  auto f2 = w.wait(*connection, "small");
+  BOOST_CHECK_EQUAL( w.admitted.size(), 1 );
+  BOOST_CHECK_EQUAL( scheduler.get_stats().requests_queued, 1 );
+  w.release("big");
+  BOOST_CHECK_EQUAL( w.admitted.size(), 2 );
+  w.release("small");
+  f1.wait(); f2.wait();
+  BOOST_CHECK_EQUAL( scheduler.get_stats().cost_in_flight, 0 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( rejected_requests_test )
+{ try {
+  api_request_scheduler scheduler(1, {});
+  auto busy = scheduler.open_connection(make_access(0));
+  auto connection = scheduler.open_connection(make_access(0, 4, 1, 50));
+  waiters w(scheduler);
+  auto blocker = scheduler.admit(*busy, "get_account_count", fc::variants());
+
+  BOOST_TEST_MESSAGE("A connection cannot queue more than max_queued_requests.");
+  auto f1 = w.wait(*connection, "queued");
+  GRAPHENE_REQUIRE_THROW( scheduler.admit(*connection, "get_accounts", fc::variants()), fc::exception );
+  BOOST_CHECK_EQUAL( scheduler.get_stats().methods.at("get_accounts").rejected, 1 );
+
+  BOOST_TEST_MESSAGE("A request not admitted within max_queue_time_ms is withdrawn.");
+  BOOST_CHECK_THROW( f1.wait(), fc::exception );
+  auto stats = scheduler.get_stats();
+  BOOST_CHECK_EQUAL( stats.methods.at("get_account_count").timed_out, 1 );
+  BOOST_CHECK_EQUAL( stats.requests_queued, 0 );
+  BOOST_CHECK( w.admitted.empty() );
+
+  BOOST_TEST_MESSAGE("It is answered with a JSON-RPC error for the request's id.");
+  try
+  {
+    scheduler.admit(*connection, "get_account_count", fc::variants());
+    BOOST_FAIL("request should time out");
+  }
+  catch( const fc::exception& e )
+  {
+    const auto reply = graphene::app::scheduled_websocket_api_connection::make_rejection_reply(fc::variant(7), e).get_object();
+    BOOST_CHECK_EQUAL( reply["id"].as_int64(), 7 );
+    BOOST_CHECK_EQUAL( reply["jsonrpc"].as_string(), "2.0" );
+    BOOST_CHECK_EQUAL( reply["error"]["code"].as_int64(), -32001 );
+    BOOST_CHECK( reply["error"]["message"].as_string().find("not admitted within 50 ms") != std::string::npos );
+  }
+
+  blocker.reset();
+  BOOST_CHECK_EQUAL( scheduler.get_stats().cost_in_flight, 0 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( cancelled_request_test )
+{ try {
+  api_request_scheduler scheduler(1, {});
+  auto busy = scheduler.open_connection(make_access(0));
+  auto connection = scheduler.open_connection(make_access(0));
+  waiters w(scheduler);
+  auto blocker = scheduler.admit(*busy, "get_account_count", fc::variants());
+
+  BOOST_TEST_MESSAGE("A cancelled waiter leaves the queue.");
+  auto f1 = w.wait(*connection, "cancelled");
+  BOOST_CHECK_EQUAL( scheduler.get_stats().requests_queued, 1 );
+  f1.cancel();
+  w.run_pending();
+  BOOST_CHECK_THROW( f1.wait(), fc::exception );
+  BOOST_CHECK_EQUAL( scheduler.get_stats().requests_queued, 0 );
+
+  BOOST_TEST_MESSAGE("And its share of the budget is never held.");
+  blocker.reset();
+  w.run_pending();
+  BOOST_CHECK( w.admitted.empty() );
+  auto stats = scheduler.get_stats();
+  BOOST_CHECK_EQUAL( stats.cost_in_flight, 0 );
+  BOOST_CHECK_EQUAL( stats.requests_in_flight, 0 );
+
+  BOOST_TEST_MESSAGE("Nor when the waiter is cancelled after being admitted, before it gets to run.");
+  blocker = scheduler.admit(*busy, "get_account_count", fc::variants());
+  auto f2 = w.wait(*connection, "admitted_then_cancelled");
+  blocker.reset();
+  f2.cancel();
+  w.run_pending();
+  try { f2.wait(); } catch( const fc::exception& ) {}
+  // whether or not the cancellation reached the waiter in time, nothing is left over once its ticket is gone
+  w.tickets.clear();
+  stats = scheduler.get_stats();
+  BOOST_CHECK_EQUAL( stats.cost_in_flight, 0 );
+  BOOST_CHECK_EQUAL( stats.requests_in_flight, 0 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()  // api_request_scheduler_tests
+BOOST_AUTO_TEST_SUITE_END()  // dascoin_tests
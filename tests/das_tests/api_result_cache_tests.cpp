@@ -0,0 +1,93 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <boost/test/unit_test.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/app/api_result_cache.hpp>
+#include <graphene/app/database_api.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( dascoin_tests, database_fixture )
+
+BOOST_FIXTURE_TEST_SUITE( api_result_cache_tests, database_fixture )
+
+BOOST_AUTO_TEST_CASE( cached_results_test )
+{ try {
+  graphene::app::application_options app_options;
+  app_options.api_result_cache = std::make_shared<graphene::app::api_result_cache>(db, 1024 * 1024);
+  graphene::app::database_api db_api(db, &app_options);
+
+  BOOST_TEST_MESSAGE("The second call within a block is served from the cache.");
+  const auto license_types = db_api.get_license_types();
+  BOOST_CHECK_EQUAL( db_api.get_license_types().size(), license_types.size() );
+  db_api.get_reward_queue_size();
+  auto stats = *db_api.get_api_result_cache_stats();
+  BOOST_CHECK_EQUAL( stats.hits, 1 );
+  BOOST_CHECK_EQUAL( stats.misses, 2 );
+  BOOST_CHECK_EQUAL( stats.entries, 2 );
+
+  BOOST_TEST_MESSAGE("Different parameters are cached separately.");
+  db_api.get_das33_projects("", 10);
+  db_api.get_das33_projects("a", 10);
+  stats = *db_api.get_api_result_cache_stats();
+  BOOST_CHECK_EQUAL( stats.misses, 4 );
+  BOOST_CHECK_EQUAL( stats.entries, 4 );
+
+  BOOST_TEST_MESSAGE("Applying a block drops everything.");
+  generate_block();
+  stats = *db_api.get_api_result_cache_stats();
+  BOOST_CHECK_EQUAL( stats.entries, 0 );
+  BOOST_CHECK_EQUAL( stats.size_in_bytes, 0 );
+  db_api.get_license_types();
+  BOOST_CHECK_EQUAL( db_api.get_api_result_cache_stats()->misses, 5 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( cache_size_limit_test )
+{ try {
+  graphene::app::application_options app_options;
+  const auto license_types_size = fc::raw::pack_size(graphene::app::database_api(db, &app_options).get_license_types());
+  app_options.api_result_cache = std::make_shared<graphene::app::api_result_cache>(db, license_types_size + 3);
+  graphene::app::database_api db_api(db, &app_options);
+
+  db_api.get_license_types();
+  db_api.get_reward_queue_size();
+  db_api.get_reward_queue_size();
+
+  BOOST_TEST_MESSAGE("The oldest entry is evicted to make room for a new one.");
+  const auto stats = *db_api.get_api_result_cache_stats();
+  BOOST_CHECK_EQUAL( stats.evictions, 1 );
+  BOOST_CHECK_EQUAL( stats.entries, 1 );
+  BOOST_CHECK_EQUAL( stats.hits, 1 );
+  BOOST_CHECK_LE( stats.size_in_bytes, stats.max_size_in_bytes );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()  // api_result_cache_tests
+BOOST_AUTO_TEST_SUITE_END()  // dascoin_tests
@@ -0,0 +1,246 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/exceptions.hpp>
+
+#include <graphene/chain/access_footprint.hpp>
+#include <graphene/chain/account_object.hpp>
+
+#include <fc/thread/thread.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( dascoin_tests, database_fixture )
+
+BOOST_FIXTURE_TEST_SUITE( block_production_tests, database_fixture )
+
+BOOST_AUTO_TEST_CASE( speculative_block_assembly_test )
+{ try {
+  ACTORS((foo)(bar)(foobar));
+
+  push_op(set_roll_back_enabled_operation(foo_id, false), false);
+
+  BOOST_TEST_MESSAGE("Assemble the next block ahead of its slot.");
+  db.assemble_speculative_block(db.get_slot_time(1), db.get_scheduled_witness(1));
+
+  BOOST_TEST_MESSAGE("Transactions pushed after assembly end up in the candidate as well.");
+  push_op(set_roll_back_enabled_operation(bar_id, false), false);
+
+  auto block = generate_block();
+  BOOST_CHECK_EQUAL( block.transactions.size(), 2 );
+  BOOST_CHECK( !foo.roll_back_enabled );
+  BOOST_CHECK( !bar.roll_back_enabled );
+
+  BOOST_TEST_MESSAGE("A candidate is discarded once the pending state is reset.");
+  push_op(set_roll_back_enabled_operation(foobar_id, false), false);
+  db.assemble_speculative_block(db.get_slot_time(1), db.get_scheduled_witness(1));
+  db.clear_pending();
+
+  block = generate_block();
+  BOOST_CHECK( block.transactions.empty() );
+  BOOST_CHECK( foobar.roll_back_enabled );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( concurrent_reads_test )
+{ try {
+  db.enable_concurrent_reads(true);
+  fc::thread reader("reader");
+
+  for (int i = 0; i < 5; ++i)
+  {
+    generate_block();
+    auto read_head = reader.async([this]() {
+      return db.with_read_lock([this]() { return std::make_pair(db.head_block_num(), db.head_block_id()); });
+    }, "read_head").wait();
+    BOOST_CHECK_EQUAL( read_head.first, db.head_block_num() );
+    BOOST_CHECK( read_head.second == db.head_block_id() );
+  }
+
+  db.enable_concurrent_reads(false);
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( precomputed_transactions_test )
+{ try {
+  ACTORS((foo)(bar)(foobar));
+  db.set_transaction_precompute_threads(2);
+
+  push_op(set_roll_back_enabled_operation(foo_id, false), false);
+  push_op(set_roll_back_enabled_operation(bar_id, false), false);
+  push_op(set_roll_back_enabled_operation(foobar_id, false), false);
+
+  auto block = generate_block();
+  BOOST_CHECK_EQUAL( block.transactions.size(), 3 );
+  BOOST_CHECK( !foo.roll_back_enabled );
+  BOOST_CHECK( !bar.roll_back_enabled );
+  BOOST_CHECK( !foobar.roll_back_enabled );
+
+  BOOST_TEST_MESSAGE("Applying the same block again gives the same state.");
+  db.pop_block();
+  db.clear_pending();
+  BOOST_CHECK( foo.roll_back_enabled );
+  db.precompute_transactions(block);
+  db.push_block(block);
+  BOOST_CHECK( db.head_block_id() == block.id() );
+  BOOST_CHECK( !foo.roll_back_enabled );
+  BOOST_CHECK( !bar.roll_back_enabled );
+  BOOST_CHECK( !foobar.roll_back_enabled );
+  for( const auto& trx : block.transactions )
+    BOOST_CHECK( db.is_known_transaction(trx.id()) );
+
+  db.set_transaction_precompute_threads(0);
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( applied_operations_by_reference_test )
+{ try {
+  ACTORS((foo)(bar));
+
+  vector<operation> applied;
+  auto connection = db.applied_block.connect([&](const signed_block& b) {
+    for( const auto& o : db.get_applied_operations() )
+      if( o.valid() && o->block_num == b.block_num() )
+        applied.push_back(o->op);
+  });
+
+  push_op(set_roll_back_enabled_operation(foo_id, false), false);
+  push_op(set_roll_back_enabled_operation(bar_id, false), false);
+  generate_block();
+  connection.disconnect();
+
+  BOOST_REQUIRE_EQUAL( applied.size(), 2 );
+  BOOST_CHECK( applied[0].get<set_roll_back_enabled_operation>().account == foo_id );
+  BOOST_CHECK( applied[1].get<set_roll_back_enabled_operation>().account == bar_id );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( execution_profiler_test )
+{ try {
+  ACTORS((foo));
+  auto& profiler = db.get_execution_profiler();
+  BOOST_CHECK( !profiler.enabled() );
+
+  profiler.enable(true);
+  push_op(set_roll_back_enabled_operation(foo_id, false), false);
+  generate_block();
+
+  auto find = [](const vector<execution_profile_entry>& entries, const string& name) {
+    return std::find_if(entries.begin(), entries.end(), [&](const execution_profile_entry& e) { return e.name == name; });
+  };
+  auto profile = profiler.get_profile();
+  BOOST_CHECK( profile.enabled );
+  auto op_entry = find(profile.operations, "graphene::chain::set_roll_back_enabled_operation");
+  BOOST_REQUIRE( op_entry != profile.operations.end() );
+  // When pushed, when the block is generated and when it is applied
+  BOOST_CHECK_GE( op_entry->count, 2 );
+  BOOST_CHECK_EQUAL( op_entry->histogram.size(), execution_profiler::histogram_buckets );
+  auto block_entry = find(profile.phases, "apply_block");
+  BOOST_REQUIRE( block_entry != profile.phases.end() );
+  BOOST_CHECK_EQUAL( block_entry->count, 1 );
+
+  BOOST_TEST_MESSAGE("Nothing is recorded while disabled.");
+  profiler.enable(false);
+  generate_block();
+  profile = profiler.get_profile();
+  BOOST_CHECK_EQUAL( find(profile.phases, "apply_block")->count, 1 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( access_footprint_batches_test )
+{ try {
+  const account_id_type a(100), b(101), c(102), d(103), fee_pool(104);
+  auto footprint_of = [](const operation& op) {
+    access_footprint result;
+    operation_get_access_footprint(op, result);
+    return result;
+  };
+
+  transfer_operation a_to_b;
+  a_to_b.from = a;
+  a_to_b.to = b;
+  transfer_operation c_to_d;
+  c_to_d.from = c;
+  c_to_d.to = d;
+  transfer_operation b_to_c;
+  b_to_c.from = b;
+  b_to_c.to = c;
+
+  BOOST_TEST_MESSAGE("Transfers between distinct accounts do not conflict.");
+  auto batches = build_conflict_free_batches({footprint_of(a_to_b), footprint_of(c_to_d), footprint_of(b_to_c)});
+  BOOST_REQUIRE_EQUAL( batches.size(), 2 );
+  BOOST_CHECK( batches[0] == vector<uint32_t>({0, 1}) );
+  BOOST_CHECK( batches[1] == vector<uint32_t>({2}) );
+
+  BOOST_TEST_MESSAGE("Fees credited to the fee pool account do not conflict, burnt fees do.");
+  c_to_d.fee = asset(1, asset_id_type(1));
+  a_to_b.fee = asset(1, asset_id_type(1));
+  batches = build_conflict_free_batches({footprint_of(a_to_b), footprint_of(c_to_d)}, fee_pool);
+  BOOST_CHECK_EQUAL( batches.size(), 1 );
+  batches = build_conflict_free_batches({footprint_of(a_to_b), footprint_of(c_to_d)});
+  BOOST_CHECK_EQUAL( batches.size(), 2 );
+  transfer_operation to_fee_pool;
+  to_fee_pool.from = d;
+  to_fee_pool.to = fee_pool;
+  batches = build_conflict_free_batches({footprint_of(a_to_b), footprint_of(to_fee_pool)}, fee_pool);
+  BOOST_CHECK_EQUAL( batches.size(), 2 );
+
+  BOOST_TEST_MESSAGE("Undeclared operations are applied on their own.");
+  auto undeclared = footprint_of(account_update_operation());
+  BOOST_CHECK( undeclared.unbounded );
+  a_to_b.fee = c_to_d.fee = asset();
+  batches = build_conflict_free_batches({footprint_of(a_to_b), undeclared, footprint_of(c_to_d)});
+  BOOST_REQUIRE_EQUAL( batches.size(), 3 );
+  BOOST_CHECK( batches[1] == vector<uint32_t>({1}) );
+
+  BOOST_TEST_MESSAGE("Reading an object orders the operation after earlier writes and before later ones.");
+  submit_cycles_to_queue_operation submit_a;
+  submit_a.account = a;
+  daspay_debit_account_operation debit_b;
+  debit_b.account = b;
+  debit_b.clearing_account = b;
+  submit_cycles_to_queue_operation submit_c;
+  submit_c.account = c;
+  BOOST_CHECK( footprint_of(debit_b).reads.count(dynamic_global_property_id_type()) );
+  batches = build_conflict_free_batches({footprint_of(submit_a), footprint_of(debit_b), footprint_of(submit_c)});
+  BOOST_REQUIRE_EQUAL( batches.size(), 3 );
+  BOOST_CHECK( batches[1] == vector<uint32_t>({1}) );
+
+  BOOST_TEST_MESSAGE("Creating objects of the same type is declared but not a conflict, ids follow the order applied.");
+  auto a_to_b_footprint = footprint_of(a_to_b);
+  auto c_to_d_footprint = footprint_of(c_to_d);
+  const auto balance_type = std::make_pair(uint8_t(account_balance_object::space_id), uint8_t(account_balance_object::type_id));
+  BOOST_CHECK( a_to_b_footprint.creates.count(balance_type) );
+  BOOST_CHECK( c_to_d_footprint.creates.count(balance_type) );
+  batches = build_conflict_free_batches({a_to_b_footprint, c_to_d_footprint});
+  BOOST_REQUIRE_EQUAL( batches.size(), 1 );
+  BOOST_CHECK( batches[0] == vector<uint32_t>({0, 1}) );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()  // block_production_tests
+BOOST_AUTO_TEST_SUITE_END()  // dascoin_tests
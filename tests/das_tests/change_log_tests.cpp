@@ -0,0 +1,144 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <boost/test/unit_test.hpp>
+#include <boost/program_options.hpp>
+#include <graphene/change_log/change_log_plugin.hpp>
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/io/json.hpp>
+
+#include <fstream>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+using graphene::change_log::change_record;
+
+namespace {
+
+void start_change_log( graphene::change_log::change_log_plugin& plugin, graphene::app::application& app,
+                       const fc::path& dir )
+{
+  boost::program_options::variables_map options;
+  options.emplace( "change-log-dir", boost::program_options::variable_value( boost::filesystem::path( dir.string() ), false ) );
+  plugin.plugin_set_app( &app );
+  plugin.plugin_initialize( options );
+  plugin.plugin_startup();
+}
+
+vector<change_record> read_segment( const fc::path& segment )
+{
+  vector<change_record> records;
+  std::ifstream in( segment.string() );
+  std::string line;
+  while( std::getline( in, line ) )
+    records.push_back( fc::json::from_string( line ).as<change_record>( GRAPHENE_MAX_NESTED_OBJECTS ) );
+  return records;
+}
+
+}
+
+BOOST_FIXTURE_TEST_SUITE( dascoin_tests, database_fixture )
+
+BOOST_FIXTURE_TEST_SUITE( change_log_tests, database_fixture )
+
+BOOST_AUTO_TEST_CASE( change_log_segment_test )
+{ try {
+  fc::temp_directory dir( graphene::utilities::temp_directory_path() );
+  const auto segment = dir.path() / "00000000000000000000.ndjson";
+  uint32_t last_block_num = 0;
+
+  {
+    graphene::change_log::change_log_plugin plugin;
+    start_change_log( plugin, app, dir.path() );
+
+    ACTORS((foo)(bar));
+    generate_block();
+    generate_block();
+    last_block_num = db.head_block_num();
+    plugin.plugin_shutdown();
+  }
+
+  BOOST_TEST_MESSAGE("Every block's records are numbered in sequence and closed by a block_end record.");
+  const auto records = read_segment( segment );
+  BOOST_REQUIRE( !records.empty() );
+  uint64_t in_block = 0;
+  uint32_t blocks = 0;
+  bool account_created = false;
+  for( size_t i = 0; i < records.size(); ++i )
+  {
+    const auto& record = records[i];
+    BOOST_CHECK_EQUAL( record.sequence, i );
+    if( i > 0 && records[i - 1].kind != graphene::change_log::block_end )
+      BOOST_CHECK_EQUAL( record.block_num, records[i - 1].block_num );
+    if( record.kind == graphene::change_log::object_created && record.object_id->is<account_id_type>() )
+      account_created = true;
+    if( record.kind == graphene::change_log::block_end )
+    {
+      BOOST_CHECK_EQUAL( record.data.as_uint64(), in_block );
+      in_block = 0;
+      ++blocks;
+    }
+    else
+      ++in_block;
+  }
+  BOOST_CHECK( records.back().kind == graphene::change_log::block_end );
+  BOOST_CHECK_EQUAL( records.back().block_num, last_block_num );
+  BOOST_CHECK_GE( blocks, 2 );
+  BOOST_CHECK( account_created );
+
+  BOOST_TEST_MESSAGE("Records of a block cut short by a crash are dropped when the log is opened again.");
+  const auto complete_size = boost::filesystem::file_size( segment.string() );
+  {
+    std::ofstream out( segment.string(), std::ios::app );
+    auto partial = records.front();
+    partial.sequence = records.size();
+    partial.block_num = last_block_num + 1;
+    out << fc::json::to_string( fc::variant( partial, GRAPHENE_MAX_NESTED_OBJECTS ) ) << "\n";
+    out << "{\"sequence\":";
+  }
+  BOOST_REQUIRE_GT( boost::filesystem::file_size( segment.string() ), complete_size );
+  {
+    graphene::change_log::change_log_plugin plugin;
+    start_change_log( plugin, app, dir.path() );
+    BOOST_CHECK_EQUAL( boost::filesystem::file_size( segment.string() ), complete_size );
+
+    generate_block();
+    plugin.plugin_shutdown();
+  }
+
+  BOOST_TEST_MESSAGE("And the log continues after the last complete block.");
+  const auto continued = read_segment( segment );
+  BOOST_REQUIRE_GT( continued.size(), records.size() );
+  BOOST_CHECK_EQUAL( continued[records.size()].sequence, records.size() );
+  BOOST_CHECK_EQUAL( continued[records.size()].block_num, last_block_num + 1 );
+  BOOST_CHECK( continued.back().kind == graphene::change_log::block_end );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()  // change_log_tests
+BOOST_AUTO_TEST_SUITE_END()  // dascoin_tests
@@ -26,6 +26,7 @@
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/access_layer.hpp>
 #include <graphene/chain/exceptions.hpp>
+#include <graphene/chain/hardfork.hpp>
 #include <graphene/chain/das33_object.hpp>
 #include <graphene/chain/market_object.hpp>
 #include "../common/database_fixture.hpp"
@@ -587,6 +588,67 @@ BOOST_AUTO_TEST_CASE( das33_complete_project_test )
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( das33_pledge_totals_test )
+{ try {
+
+    ACTOR(user);
+    ACTOR(owner);
+    VAULT_ACTOR(vault);
+
+    tether_accounts(user_id, vault_id);
+
+    issue_dascoin(vault_id, 100);
+    disable_vault_to_wallet_limit(vault_id);
+    transfer_dascoin_vault_to_wallet(vault_id, user_id, 100 * DASCOIN_DEFAULT_ASSET_PRECISION);
+
+    asset_id_type test_asset_id = create_new_asset("TEST", 100000000, 2, price{asset(1),asset(1,asset_id_type(1))});
+
+    das33_project_create_operation project_create;
+        project_create.authority       = get_das33_administrator_id();
+        project_create.name            = "test_project0";
+        project_create.owner           = owner_id;
+        project_create.token           = test_asset_id;
+        project_create.discounts       = {{get_dascoin_asset_id(), 50}};
+        project_create.goal_amount_eur = 10000000;
+        project_create.min_pledge = 0;
+        project_create.max_pledge = 10000000;
+    do_op(project_create);
+
+    das33_project_object project = get_das33_projects()[0];
+
+    das33_project_update_operation project_update;
+        project_update.project_id = project.id;
+        project_update.authority  = get_das33_administrator_id();
+        project_update.status     = das33_project_status::active;
+    do_op(project_update);
+
+    const auto& totals = dynamic_cast<const primary_index<das33_pledge_holder_index>&>(db.get_index_type<das33_pledge_holder_index>())
+                           .get_secondary_index<das33_pledge_totals_index>();
+    BOOST_CHECK_EQUAL( totals.get_user_round_total(user_id, project.id, 0).value, 0 );
+    BOOST_CHECK( totals.get_project_totals(project.id).empty() );
+
+    do_op_no_balance_check(das33_pledge_asset_operation(user_id, asset{10 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()}, optional<license_type_id_type>{}, project.id));
+    do_op_no_balance_check(das33_pledge_asset_operation(user_id, asset{20 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()}, optional<license_type_id_type>{}, project.id));
+
+    auto pledges = get_das33_pledges();
+    BOOST_CHECK_EQUAL( totals.get_user_round_total(user_id, project.id, 0).value, (pledges[0].base_expected.amount + pledges[1].base_expected.amount).value );
+    BOOST_CHECK_EQUAL( totals.get_user_round_total(user_id, project.id, 1).value, 0 );
+    auto project_totals = totals.get_project_totals(project.id);
+    BOOST_CHECK_EQUAL( project_totals.size(), 1 );
+    BOOST_CHECK( project_totals[0] == asset(30 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()) );
+
+    // Distributed pledges are no longer counted:
+    do_op_no_balance_check(das33_distribute_pledge_operation(get_das33_administrator_id(), pledges[0].id, 10000, 10000, 10000));
+    BOOST_CHECK_EQUAL( totals.get_user_round_total(user_id, project.id, 0).value, pledges[1].base_expected.amount.value );
+    BOOST_CHECK( totals.get_project_totals(project.id)[0] == asset(20 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()) );
+
+    // Unless that is undone:
+    db.pop_block();
+    BOOST_CHECK_EQUAL( totals.get_user_round_total(user_id, project.id, 0).value, (pledges[0].base_expected.amount + pledges[1].base_expected.amount).value );
+    BOOST_CHECK( totals.get_project_totals(project.id)[0] == asset(30 * DASCOIN_DEFAULT_ASSET_PRECISION, get_dascoin_asset_id()) );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( das33_reject_project_test )
 { try {
 
@@ -324,6 +324,40 @@ BOOST_AUTO_TEST_CASE( unreserve_asset_on_account_test )
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( resolve_several_delayed_operations_test )
+{ try {
+  ACTORS((foo)(bar)(foobar));
+  VAULT_ACTORS((foov)(barv)(foobarv));
+
+  do_op(update_delayed_operations_resolver_parameters_operation(db.get_global_properties().authorities.root_administrator, true, 600));
+
+  const vector<std::pair<account_id_type, account_id_type>> pairs = {{foo_id, foov_id}, {bar_id, barv_id}, {foobar_id, foobarv_id}};
+  for( const auto& p : pairs )
+  {
+    tether_accounts(p.first, p.second);
+    issue_dascoin(p.second, 100);
+    disable_vault_to_wallet_limit(p.second);
+    transfer_dascoin_vault_to_wallet(p.second, p.first, 100 * DASCOIN_DEFAULT_ASSET_PRECISION);
+    do_op(reserve_asset_on_account_operation(p.first, asset{ 50 * DASCOIN_DEFAULT_ASSET_PRECISION, db.get_dascoin_asset_id() }));
+  }
+
+  // All three are due in the same resolver run:
+  for( const auto& p : pairs )
+    push_op(unreserve_asset_on_account_operation(p.first, asset{ 10 * DASCOIN_DEFAULT_ASSET_PRECISION, db.get_dascoin_asset_id() }));
+  generate_block();
+  BOOST_CHECK_EQUAL( db.get_index_type<delayed_operations_index>().indices().size(), 3 );
+
+  generate_blocks(db.head_block_time() + fc::seconds(660));
+
+  BOOST_CHECK_EQUAL( db.get_index_type<delayed_operations_index>().indices().size(), 0 );
+  for( const auto& p : pairs )
+  {
+    BOOST_CHECK_EQUAL( get_balance(p.first, get_dascoin_asset_id()), 60 * DASCOIN_DEFAULT_ASSET_PRECISION );
+    BOOST_CHECK_EQUAL( get_reserved_balance(p.first, get_dascoin_asset_id()), 40 * DASCOIN_DEFAULT_ASSET_PRECISION );
+  }
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( daspay_debit_test )
 { try {
   ACTORS((foo)(clearing1)(payment1)(clearing2)(payment2)(foobar));
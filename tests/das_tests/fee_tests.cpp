@@ -234,6 +234,55 @@ BOOST_AUTO_TEST_CASE( successful_pool_account_change_and_cycle_submit_test )
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( fee_pool_credited_once_per_block_test )
+{ try {
+   auto root_id = db.get_global_properties().authorities.root_administrator;
+
+   change_operation_fee_operation cffo;
+   cffo.issuer = root_id;
+   cffo.new_fee = 10;
+   cffo.op_num = operation::tag<transfer_operation>::value;
+   do_op(cffo);
+
+   ACTORS((alice)(bob)(pool));
+   issue_webasset("1", alice_id, 100, 0);
+   issue_cycleasset("CL1", alice_id, 100, 0);
+   // this will make cycle balance object for pool account
+   issue_cycleasset("pool", pool_id, 10, 0);
+
+   change_fee_pool_account_operation cfpao;
+   cfpao.issuer = root_id;
+   cfpao.fee_pool_account_id = pool_id;
+   do_op(cfpao);
+
+   const auto pool_balance = get_balance(pool_id, get_cycle_asset_id());
+   const auto alice_cycles = get_balance(alice_id, get_cycle_asset_id());
+
+   for ( int i = 1; i <= 3; ++i )
+   {
+      transfer_operation top;
+      top.from = alice_id;
+      top.to = bob_id;
+      top.amount = asset{i, get_web_asset_id()};
+      top.fee = asset{10, get_cycle_asset_id()};
+      push_op(top, false);
+   }
+
+   auto block = generate_block();
+   BOOST_CHECK_EQUAL( block.transactions.size(), 3 );
+   BOOST_CHECK_EQUAL( get_balance(pool_id, get_cycle_asset_id()), pool_balance + 30 );
+   BOOST_CHECK_EQUAL( get_balance(alice_id, get_cycle_asset_id()), alice_cycles - 30 );
+
+   BOOST_TEST_MESSAGE("Applying the block again gives the same balances.");
+   db.pop_block();
+   db.clear_pending();
+   BOOST_CHECK_EQUAL( get_balance(pool_id, get_cycle_asset_id()), pool_balance );
+   db.push_block(block);
+   BOOST_CHECK_EQUAL( get_balance(pool_id, get_cycle_asset_id()), pool_balance + 30 );
+   BOOST_CHECK_EQUAL( get_balance(alice_id, get_cycle_asset_id()), alice_cycles - 30 );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -630,6 +630,45 @@ BOOST_AUTO_TEST_CASE( upgrade_cycles_test )
 
 } FC_LOG_AND_RETHROW() }
 
+BOOST_AUTO_TEST_CASE( upgradeable_license_index_test )
+{ try {
+  VAULT_ACTOR(foo);
+  VAULT_ACTOR(bar);
+
+  auto standard_locked = *(_dal.get_license_type("standard_locked"));
+  const share_type bonus_percent = 0;
+  const share_type frequency_lock = 100;
+  const time_point_sec issue_time = db.head_block_time();
+  const auto& dgpo = db.get_dynamic_global_properties();
+  const auto& idx = db.get_index_type<license_information_index>().indices().get<by_earliest_upgradeable_activation>();
+
+  do_op(issue_license_operation(get_license_issuer_id(), foo_id, standard_locked.id,
+                                bonus_percent, frequency_lock, issue_time));
+
+  const auto& foo_license_information = (*foo.license_information)(db);
+  BOOST_CHECK( foo_license_information.earliest_upgradeable_activation() == issue_time );
+  BOOST_CHECK_EQUAL( std::distance(idx.begin(), idx.upper_bound(issue_time)), 1 );
+
+  // Bar's license is activated after the cutoff time, so it is not eligible for the upgrade:
+  const time_point_sec cutoff_time = dgpo.next_maintenance_time;
+  do_op(issue_license_operation(get_license_issuer_id(), bar_id, standard_locked.id,
+                                bonus_percent, frequency_lock, cutoff_time + fc::seconds(1)));
+  BOOST_CHECK_EQUAL( std::distance(idx.begin(), idx.upper_bound(cutoff_time)), 1 );
+
+  do_op(create_upgrade_event_operation(get_license_administrator_id(),
+                                       dgpo.next_maintenance_time,
+                                       cutoff_time, {}, "foo"));
+  generate_blocks(dgpo.next_maintenance_time);
+
+  BOOST_CHECK_EQUAL( get_cycle_balance(foo_id).value, 2 * DASCOIN_BASE_STANDARD_CYCLES );
+  BOOST_CHECK_EQUAL( get_cycle_balance(bar_id).value, DASCOIN_BASE_STANDARD_CYCLES );
+
+  // A standard license is upgraded only once, so foo is no longer indexed as upgradeable:
+  BOOST_CHECK( foo_license_information.earliest_upgradeable_activation() == time_point_sec::maximum() );
+  BOOST_CHECK_EQUAL( std::distance(idx.begin(), idx.upper_bound(cutoff_time)), 0 );
+
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_CASE( upgrade_president_cycles_test )
 { try {
   VAULT_ACTOR(foo);
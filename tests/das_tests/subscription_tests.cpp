@@ -0,0 +1,75 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <boost/test/unit_test.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/app/database_api.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( dascoin_tests, database_fixture )
+
+BOOST_FIXTURE_TEST_SUITE( subscription_tests, database_fixture )
+
+BOOST_AUTO_TEST_CASE( objects_fetched_by_typed_id_are_reported_test )
+{ try {
+  ACTORS((alice)(bob));
+  const auto lic_id = _dal.get_license_type("standard")->id;
+
+  set<object_id_type> changed;
+  auto callback = [&](const variant& updates) {
+    for( const variant& update : updates.get_array() )
+      if( update.is_object() && update.get_object().contains("id") )
+        changed.insert(update.get_object()["id"].as<object_id_type>(1));
+  };
+  graphene::app::database_api db_api(db);
+  db_api.set_subscribe_callback(callback, false);
+
+  // The getters a wallet caches objects from; bob is never fetched
+  BOOST_REQUIRE( db_api.get_accounts({alice_id}).front().valid() );
+  BOOST_REQUIRE( db_api.get_license_types({lic_id}).front().valid() );
+
+  BOOST_TEST_MESSAGE("Replacing an account's active key is reported to a subscriber that fetched it by id.");
+  account_update_operation update;
+  update.account = alice_id;
+  update.active = authority(1, public_key_type(generate_private_key("alice_new_active").get_public_key()), 1);
+  do_op(update);
+  BOOST_CHECK( alice_id(db).active == *update.active );
+
+  BOOST_TEST_MESSAGE("So is editing a licence type.");
+  do_op(edit_license_type_operation(get_license_administrator_id(), lic_id, "standard_plus", 200, 10));
+
+  fc::usleep(fc::milliseconds(200)); // the callback runs in a separate task
+  BOOST_CHECK( changed.count(alice_id) );
+  BOOST_CHECK( changed.count(lic_id) );
+  BOOST_CHECK( !changed.count(bob_id) );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()  // subscription_tests
+BOOST_AUTO_TEST_SUITE_END()  // dascoin_tests
@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2018 Tech Solutions Malta LTD
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <boost/test/unit_test.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/witness_object.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( dascoin_tests, database_fixture )
+
+BOOST_FIXTURE_TEST_SUITE( vote_tally_tests, database_fixture )
+
+BOOST_AUTO_TEST_CASE( incremental_vote_tally_test )
+{ try {
+  ACTORS((alice)(bob)(charlie));
+  db.set_vote_tally_verification(true);
+  generate_block();
+
+  const auto witness_vote = witness_id_type()(db).vote_id;
+
+  BOOST_TEST_MESSAGE("Bob's stake votes with Alice's opinions.");
+  db.modify(alice, [&](account_object& a){
+    a.options.votes.insert(witness_vote);
+    a.options.num_witness = 1;
+  });
+  db.modify(bob, [&](account_object& a){ a.options.voting_account = alice_id; });
+  db.adjust_balance(alice_id, asset(1000));
+  db.adjust_balance(bob_id, asset(500));
+
+  generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+  BOOST_CHECK_EQUAL( db.get_vote_tally_mismatches(), 0 );
+
+  BOOST_TEST_MESSAGE("Changing the opinions of a proxy moves the stake of the accounts using it.");
+  db.modify(alice, [&](account_object& a){
+    a.options.votes.clear();
+    a.options.num_witness = 0;
+  });
+  db.modify(charlie, [&](account_object& a){
+    a.options.votes.insert(witness_vote);
+    a.options.num_witness = 1;
+  });
+  db.adjust_balance(charlie_id, asset(200));
+  db.adjust_balance(bob_id, asset(-100));
+
+  generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+  BOOST_CHECK_EQUAL( db.get_vote_tally_mismatches(), 0 );
+
+  BOOST_TEST_MESSAGE("Dropping the proxy makes the stake vote with its own opinions again.");
+  db.modify(bob, [&](account_object& a){ a.options.voting_account = GRAPHENE_PROXY_TO_SELF_ACCOUNT; });
+
+  generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+  BOOST_CHECK_EQUAL( db.get_vote_tally_mismatches(), 0 );
+
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_SUITE_END()  // vote_tally_tests
+BOOST_AUTO_TEST_SUITE_END()  // dascoin_tests